@@ -6,19 +6,77 @@
 //! Monitors for HDMI/VGA cable plug/unplug events during capture.
 //! When topology changes, triggers a callback to kill the capture process.
 //! This prevents ghost freezes and jumps to primary screen.
+//!
+//! On Linux the watcher is driven by kernel uevents for the drm subsystem
+//! and never wakes while nothing is plugged; other platforms (and Linux
+//! without netlink access) poll.
+
+#[cfg(target_os = "linux")]
+mod uevent;
 
 use std::sync::atomic::{AtomicBool, Ordering};
 use std::sync::Arc;
 use std::thread::{self, JoinHandle};
 use std::time::{Duration, Instant};
 
+/// Quiet time after the last drm uevent before connectors are re-counted.
+#[cfg(target_os = "linux")]
+const UEVENT_DEBOUNCE: Duration = Duration::from_millis(150);
+
 pub struct DisplayWatcher {
     running: Arc<AtomicBool>,
     handle: Option<JoinHandle<()>>,
+    #[cfg(target_os = "linux")]
+    waker: Option<Arc<uevent::Waker>>,
 }
 
 impl DisplayWatcher {
     pub fn start<F>(on_change: F) -> Self
+    where
+        F: FnOnce() + Send + 'static,
+    {
+        #[cfg(target_os = "linux")]
+        if let Ok(socket) = uevent::open_socket() {
+            if let Ok(waker) = uevent::Waker::new() {
+                return Self::start_uevent(socket, Arc::new(waker), on_change);
+            }
+        }
+
+        Self::start_polling(on_change)
+    }
+
+    #[cfg(target_os = "linux")]
+    fn start_uevent<F>(socket: std::os::fd::OwnedFd, waker: Arc<uevent::Waker>, on_change: F) -> Self
+    where
+        F: FnOnce() + Send + 'static,
+    {
+        use std::os::fd::AsRawFd;
+
+        let running = Arc::new(AtomicBool::new(true));
+        let thread_waker = waker.clone();
+
+        // The socket is open before the baseline is read, so a change that
+        // lands in between is still delivered.
+        let handle = thread::spawn(move || {
+            let initial = DisplayMonitor::get_monitor_count();
+            uevent::run(
+                socket.as_raw_fd(),
+                thread_waker.fd(),
+                UEVENT_DEBOUNCE,
+                initial,
+                DisplayMonitor::get_monitor_count,
+                on_change,
+            );
+        });
+
+        Self {
+            running,
+            handle: Some(handle),
+            waker: Some(waker),
+        }
+    }
+
+    fn start_polling<F>(on_change: F) -> Self
     where
         F: FnOnce() + Send + 'static,
     {
@@ -40,11 +98,21 @@ impl DisplayWatcher {
         Self {
             running,
             handle: Some(handle),
+            #[cfg(target_os = "linux")]
+            waker: None,
         }
     }
 
-    pub fn stop(mut self) {
+    fn signal_stop(&self) {
         self.running.store(false, Ordering::Relaxed);
+        #[cfg(target_os = "linux")]
+        if let Some(waker) = &self.waker {
+            waker.wake();
+        }
+    }
+
+    pub fn stop(mut self) {
+        self.signal_stop();
         if let Some(handle) = self.handle.take() {
             let _ = handle.join();
         }
@@ -53,7 +121,7 @@ impl DisplayWatcher {
 
 impl Drop for DisplayWatcher {
     fn drop(&mut self) {
-        self.running.store(false, Ordering::Relaxed);
+        self.signal_stop();
     }
 }
 
@@ -0,0 +1,342 @@
+// Copyright 2026 a7mddra
+// SPDX-License-Identifier: Apache-2.0
+
+//! Kernel uevent listener for DRM connector changes (Linux)
+//!
+//! The watcher thread sleeps in `poll()` on a `NETLINK_KOBJECT_UEVENT`
+//! socket and an eventfd used to stop it, so an idle session costs no
+//! wakeups at all. A drm uevent arms a short debounce deadline, which
+//! becomes the poll timeout; further events push it back. When it expires
+//! the connectors are counted once and the callback fires if the count
+//! changed. Nothing sleeps, so stopping is immediate at any point.
+
+use std::io;
+use std::os::fd::{AsRawFd, FromRawFd, OwnedFd, RawFd};
+use std::time::{Duration, Instant};
+
+/// Kernel broadcast group (1). udevd re-broadcasts on group 2 with a
+/// "libudev" header, which we neither need nor parse.
+const KERNEL_GROUP: u32 = 1;
+
+const RECV_BUFFER: usize = 8192;
+
+/// The parts of a kernel uevent the watcher cares about.
+#[derive(Debug, PartialEq, Eq)]
+pub(crate) struct Uevent {
+    pub action: String,
+    pub subsystem: String,
+    pub hotplug: bool,
+}
+
+impl Uevent {
+    /// Connector plug/unplug is a `change` on the card (HOTPLUG=1); some
+    /// drivers also add/remove connector devices.
+    pub fn is_display_hotplug(&self) -> bool {
+        self.subsystem == "drm"
+            && (self.hotplug || self.action == "add" || self.action == "remove")
+    }
+}
+
+/// Parses "ACTION@DEVPATH\0KEY=VALUE\0..." as sent by the kernel.
+pub(crate) fn parse(message: &[u8]) -> Option<Uevent> {
+    let mut fields = message.split(|&b| b == 0).filter(|f| !f.is_empty());
+    let head = std::str::from_utf8(fields.next()?).ok()?;
+    let (action, _devpath) = head.split_once('@')?;
+
+    let mut event = Uevent {
+        action: action.to_string(),
+        subsystem: String::new(),
+        hotplug: false,
+    };
+    for field in fields {
+        let Ok(field) = std::str::from_utf8(field) else { continue };
+        match field.split_once('=') {
+            Some(("ACTION", value)) => event.action = value.to_string(),
+            Some(("SUBSYSTEM", value)) => event.subsystem = value.to_string(),
+            Some(("HOTPLUG", value)) => event.hotplug = value == "1",
+            _ => {}
+        }
+    }
+    Some(event)
+}
+
+/// Non-blocking debounce: a deadline that every new event pushes back.
+pub(crate) struct Debounce {
+    window: Duration,
+    deadline: Option<Instant>,
+}
+
+impl Debounce {
+    pub fn new(window: Duration) -> Self {
+        Self { window, deadline: None }
+    }
+
+    pub fn note(&mut self, now: Instant) {
+        self.deadline = Some(now + self.window);
+    }
+
+    /// Poll timeout in milliseconds, rounded up; -1 (forever) when idle.
+    pub fn poll_timeout(&self, now: Instant) -> i32 {
+        match self.deadline {
+            None => -1,
+            Some(deadline) => {
+                let left = deadline.saturating_duration_since(now);
+                ((left.as_micros() + 999) / 1000).min(i32::MAX as u128) as i32
+            }
+        }
+    }
+
+    /// True once when the deadline has passed; disarms itself.
+    pub fn take_due(&mut self, now: Instant) -> bool {
+        match self.deadline {
+            Some(deadline) if now >= deadline => {
+                self.deadline = None;
+                true
+            }
+            _ => false,
+        }
+    }
+}
+
+/// Opens a non-blocking uevent socket subscribed to kernel broadcasts.
+pub(crate) fn open_socket() -> io::Result<OwnedFd> {
+    let fd = unsafe {
+        libc::socket(
+            libc::AF_NETLINK,
+            libc::SOCK_DGRAM | libc::SOCK_CLOEXEC | libc::SOCK_NONBLOCK,
+            libc::NETLINK_KOBJECT_UEVENT,
+        )
+    };
+    if fd < 0 {
+        return Err(io::Error::last_os_error());
+    }
+    let socket = unsafe { OwnedFd::from_raw_fd(fd) };
+
+    let mut addr: libc::sockaddr_nl = unsafe { std::mem::zeroed() };
+    addr.nl_family = libc::AF_NETLINK as libc::sa_family_t;
+    addr.nl_groups = KERNEL_GROUP;
+    let rc = unsafe {
+        libc::bind(
+            socket.as_raw_fd(),
+            &addr as *const libc::sockaddr_nl as *const libc::sockaddr,
+            std::mem::size_of::<libc::sockaddr_nl>() as libc::socklen_t,
+        )
+    };
+    if rc < 0 {
+        return Err(io::Error::last_os_error());
+    }
+    Ok(socket)
+}
+
+/// eventfd that wakes the watcher thread for shutdown.
+pub(crate) struct Waker(OwnedFd);
+
+impl Waker {
+    pub fn new() -> io::Result<Self> {
+        let fd = unsafe { libc::eventfd(0, libc::EFD_CLOEXEC | libc::EFD_NONBLOCK) };
+        if fd < 0 {
+            return Err(io::Error::last_os_error());
+        }
+        Ok(Self(unsafe { OwnedFd::from_raw_fd(fd) }))
+    }
+
+    pub fn wake(&self) {
+        let one: u64 = 1;
+        unsafe {
+            libc::write(
+                self.0.as_raw_fd(),
+                &one as *const u64 as *const libc::c_void,
+                std::mem::size_of::<u64>(),
+            );
+        }
+    }
+
+    pub fn fd(&self) -> RawFd {
+        self.0.as_raw_fd()
+    }
+}
+
+/// Event loop of the watcher thread. Returns true if the connector count
+/// changed (after calling `on_change`), false when woken for shutdown or
+/// if the socket fails.
+pub(crate) fn run<C, F>(
+    events: RawFd,
+    wake: RawFd,
+    debounce: Duration,
+    mut last: i32,
+    mut count: C,
+    on_change: F,
+) -> bool
+where
+    C: FnMut() -> i32,
+    F: FnOnce(),
+{
+    let mut pending = Debounce::new(debounce);
+    let mut buffer = [0u8; RECV_BUFFER];
+
+    loop {
+        let mut fds = [
+            libc::pollfd { fd: events, events: libc::POLLIN, revents: 0 },
+            libc::pollfd { fd: wake, events: libc::POLLIN, revents: 0 },
+        ];
+        let timeout = pending.poll_timeout(Instant::now());
+        let ready = unsafe { libc::poll(fds.as_mut_ptr(), fds.len() as libc::nfds_t, timeout) };
+        if ready < 0 {
+            if io::Error::last_os_error().kind() == io::ErrorKind::Interrupted {
+                continue;
+            }
+            return false;
+        }
+
+        if fds[1].revents != 0 {
+            return false;
+        }
+
+        if fds[0].revents & libc::POLLIN != 0 {
+            loop {
+                let len = unsafe {
+                    libc::recv(
+                        events,
+                        buffer.as_mut_ptr() as *mut libc::c_void,
+                        buffer.len(),
+                        libc::MSG_DONTWAIT,
+                    )
+                };
+                if len < 0 {
+                    // Overrun: events were dropped, so one may have been ours.
+                    if io::Error::last_os_error().raw_os_error() == Some(libc::ENOBUFS) {
+                        pending.note(Instant::now());
+                    }
+                    break;
+                }
+                if len == 0 {
+                    break;
+                }
+                if parse(&buffer[..len as usize]).is_some_and(|e| e.is_display_hotplug()) {
+                    pending.note(Instant::now());
+                }
+            }
+        } else if fds[0].revents & (libc::POLLERR | libc::POLLHUP | libc::POLLNVAL) != 0 {
+            return false;
+        }
+
+        if pending.take_due(Instant::now()) {
+            let current = count();
+            if current != last {
+                on_change();
+                return true;
+            }
+            last = current;
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::os::unix::net::UnixDatagram;
+    use std::sync::atomic::{AtomicUsize, Ordering};
+    use std::sync::Arc;
+    use std::thread;
+
+    const DRM_HOTPLUG: &[u8] = b"change@/devices/pci0000:00/0000:00:02.0/drm/card0\0\
+        ACTION=change\0DEVPATH=/devices/pci0000:00/0000:00:02.0/drm/card0\0\
+        SUBSYSTEM=drm\0HOTPLUG=1\0DEVNAME=/dev/dri/card0\0SEQNUM=4242\0";
+
+    const USB_ADD: &[u8] = b"add@/devices/pci0000:00/usb1/1-1\0\
+        ACTION=add\0SUBSYSTEM=usb\0SEQNUM=4243\0";
+
+    #[test]
+    fn test_parse_drm_hotplug() {
+        let event = parse(DRM_HOTPLUG).unwrap();
+        assert_eq!(event.action, "change");
+        assert_eq!(event.subsystem, "drm");
+        assert!(event.hotplug);
+        assert!(event.is_display_hotplug());
+    }
+
+    #[test]
+    fn test_parse_ignores_other_subsystems() {
+        assert!(!parse(USB_ADD).unwrap().is_display_hotplug());
+        assert!(parse(b"").is_none());
+        assert!(parse(b"libudev\0garbage").is_none());
+    }
+
+    #[test]
+    fn test_debounce_extends_and_fires_once() {
+        let start = Instant::now();
+        let mut debounce = Debounce::new(Duration::from_millis(100));
+        assert_eq!(debounce.poll_timeout(start), -1);
+
+        debounce.note(start);
+        debounce.note(start + Duration::from_millis(60));
+        assert!(!debounce.take_due(start + Duration::from_millis(120)));
+        assert_eq!(debounce.poll_timeout(start + Duration::from_millis(120)), 40);
+        assert!(debounce.take_due(start + Duration::from_millis(160)));
+        assert!(!debounce.take_due(start + Duration::from_millis(200)));
+        assert_eq!(debounce.poll_timeout(start), -1);
+    }
+
+    fn spawn_loop(
+        counts: Vec<i32>,
+    ) -> (UnixDatagram, Waker, Arc<AtomicUsize>, thread::JoinHandle<bool>) {
+        let (tx, rx) = UnixDatagram::pair().unwrap();
+        let waker = Waker::new().unwrap();
+        let wake_fd = waker.fd();
+        let calls = Arc::new(AtomicUsize::new(0));
+        let calls_clone = calls.clone();
+
+        let handle = thread::spawn(move || {
+            let mut counts = counts.into_iter();
+            run(
+                rx.as_raw_fd(),
+                wake_fd,
+                Duration::from_millis(30),
+                1,
+                move || {
+                    calls_clone.fetch_add(1, Ordering::SeqCst);
+                    counts.next().unwrap_or(1)
+                },
+                || {},
+            )
+        });
+        (tx, waker, calls, handle)
+    }
+
+    #[test]
+    fn test_synthetic_burst_coalesces_into_one_count() {
+        let (tx, _waker, calls, handle) = spawn_loop(vec![2]);
+        for _ in 0..5 {
+            tx.send(DRM_HOTPLUG).unwrap();
+        }
+        assert!(handle.join().unwrap());
+        assert_eq!(calls.load(Ordering::SeqCst), 1);
+    }
+
+    #[test]
+    fn test_unchanged_count_keeps_watching_until_woken() {
+        let (tx, waker, calls, handle) = spawn_loop(vec![1]);
+        tx.send(USB_ADD).unwrap();
+        tx.send(DRM_HOTPLUG).unwrap();
+
+        let deadline = Instant::now() + Duration::from_secs(2);
+        while calls.load(Ordering::SeqCst) == 0 && Instant::now() < deadline {
+            thread::sleep(Duration::from_millis(5));
+        }
+        assert_eq!(calls.load(Ordering::SeqCst), 1);
+
+        waker.wake();
+        assert!(!handle.join().unwrap());
+        assert_eq!(calls.load(Ordering::SeqCst), 1);
+    }
+
+    #[test]
+    fn test_non_drm_events_never_count() {
+        let (tx, waker, calls, handle) = spawn_loop(vec![2]);
+        tx.send(USB_ADD).unwrap();
+        thread::sleep(Duration::from_millis(80));
+        waker.wake();
+        assert!(!handle.join().unwrap());
+        assert_eq!(calls.load(Ordering::SeqCst), 0);
+    }
+}
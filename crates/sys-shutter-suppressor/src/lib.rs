@@ -2,61 +2,170 @@
 // SPDX-License-Identifier: Apache-2.0
 
 //! Shutter sound suppressor for screen capture
-//! 
+//!
 //! Mutes system audio during capture to suppress shutter sounds on:
 //! - macOS: CoreGraphics always plays a sound
 //! - Linux/Wayland: Portal may play a sound
-//! 
+//!
 //! Windows and X11 are silent by default, so no action needed.
+//!
+//! Muting runs on a background thread so it overlaps with starting the
+//! capture process instead of delaying it. On Linux the thread talks to
+//! the sound server directly (see `pulse`) and only falls back to
+//! `wpctl`/`pactl`/`amixer` when that is unavailable. Whatever the path,
+//! the sink is only unmuted again if it was unmuted before.
+
+#[cfg(target_os = "linux")]
+mod pulse;
 
 use std::env;
 use std::process::Command;
+use std::sync::mpsc::{self, Receiver, Sender};
 use std::sync::OnceLock;
+use std::thread::{self, JoinHandle};
+#[cfg(target_os = "linux")]
+use std::time::Duration;
 
 static HAS_WPCTL: OnceLock<bool> = OnceLock::new();
 static HAS_PACTL: OnceLock<bool> = OnceLock::new();
 
-pub struct AudioGuard;
+/// Bound for connecting to the sound server and for each request on it.
+#[cfg(target_os = "linux")]
+const SERVER_TIMEOUT: Duration = Duration::from_millis(500);
+
+/// Keeps the output muted until `unmute()` or drop.
+pub struct AudioGuard {
+    release: Option<Sender<()>>,
+    worker: Option<JoinHandle<()>>,
+}
 
 impl AudioGuard {
-    #[inline]
-    pub fn mute() {
-        #[cfg(target_os = "macos")]
-        Self::mute_macos();
+    /// Starts muting in the background and returns immediately.
+    pub fn mute() -> Self {
+        if !Self::needs_mute() {
+            return Self { release: None, worker: None };
+        }
 
-        #[cfg(target_os = "linux")]
-        if Self::is_wayland() {
-            Self::mute_linux();
+        let (release, released) = mpsc::channel();
+        let worker = thread::Builder::new()
+            .name("shutter-mute".into())
+            .spawn(move || Self::hold(released))
+            .ok();
+        Self { release: Some(release), worker }
+    }
+
+    /// Restores the original mute state and waits until it is applied.
+    pub fn unmute(mut self) {
+        self.release();
+    }
+
+    fn release(&mut self) {
+        // Dropping the sender wakes the worker, even mid-mute.
+        self.release.take();
+        if let Some(worker) = self.worker.take() {
+            let _ = worker.join();
         }
     }
 
-    #[inline]
-    pub fn unmute() {
+    fn needs_mute() -> bool {
+        #[cfg(target_os = "linux")]
+        {
+            Self::is_wayland()
+        }
         #[cfg(target_os = "macos")]
-        Self::unmute_macos();
+        {
+            true
+        }
+        #[cfg(not(any(target_os = "macos", target_os = "linux")))]
+        {
+            false
+        }
+    }
 
+    /// Worker body: mute, wait for release, restore.
+    fn hold(released: Receiver<()>) {
         #[cfg(target_os = "linux")]
-        if Self::is_wayland() {
-            Self::unmute_linux();
+        if let Some(mut client) = pulse::Client::connect(SERVER_TIMEOUT) {
+            if let Some(sink) = client.default_sink() {
+                match client.sink_muted(&sink) {
+                    Some(true) => {
+                        let _ = released.recv();
+                        return;
+                    }
+                    Some(false) if client.set_sink_muted(&sink, true) => {
+                        let _ = released.recv();
+                        if !client.set_sink_muted(&sink, false) {
+                            eprintln!("[AudioGuard] Restoring {} failed, falling back", sink);
+                            Self::unmute_cmd();
+                        }
+                        return;
+                    }
+                    _ => {}
+                }
+            }
+        }
+
+        if Self::is_muted_cmd() == Some(true) {
+            let _ = released.recv();
+            return;
+        }
+        Self::mute_cmd();
+        let _ = released.recv();
+        Self::unmute_cmd();
+    }
+
+    #[cfg(target_os = "macos")]
+    fn is_muted_cmd() -> Option<bool> {
+        let out = Command::new("osascript")
+            .args(["-e", "output muted of (get volume settings)"])
+            .output()
+            .ok()?;
+        match String::from_utf8_lossy(&out.stdout).trim() {
+            "true" => Some(true),
+            "false" => Some(false),
+            _ => None,
         }
     }
-    
+
     #[cfg(target_os = "macos")]
-    fn mute_macos() {
+    fn mute_cmd() {
         let _ = Command::new("osascript")
             .args(["-e", "set volume with output muted"])
             .output();
     }
 
     #[cfg(target_os = "macos")]
-    fn unmute_macos() {
+    fn unmute_cmd() {
         let _ = Command::new("osascript")
             .args(["-e", "set volume without output muted"])
             .output();
     }
 
     #[cfg(target_os = "linux")]
-    fn mute_linux() {
+    fn is_muted_cmd() -> Option<bool> {
+        if *HAS_WPCTL.get_or_init(|| Self::has_cmd("wpctl")) {
+            let out = Command::new("wpctl")
+                .args(["get-volume", "@DEFAULT_AUDIO_SINK@"])
+                .output()
+                .ok()?;
+            out.status
+                .success()
+                .then(|| String::from_utf8_lossy(&out.stdout).contains("[MUTED]"))
+        } else if *HAS_PACTL.get_or_init(|| Self::has_cmd("pactl")) {
+            let out = Command::new("pactl")
+                .args(["get-sink-mute", "@DEFAULT_SINK@"])
+                .output()
+                .ok()?;
+            out.status
+                .success()
+                .then(|| String::from_utf8_lossy(&out.stdout).contains("yes"))
+        } else {
+            None
+        }
+    }
+
+    #[cfg(target_os = "linux")]
+    fn mute_cmd() {
         if *HAS_WPCTL.get_or_init(|| Self::has_cmd("wpctl")) {
             let _ = Command::new("wpctl")
                 .args(["set-mute", "@DEFAULT_AUDIO_SINK@", "1"])
@@ -73,7 +182,7 @@ impl AudioGuard {
     }
 
     #[cfg(target_os = "linux")]
-    fn unmute_linux() {
+    fn unmute_cmd() {
         if *HAS_WPCTL.get_or_init(|| Self::has_cmd("wpctl")) {
             let _ = Command::new("wpctl")
                 .args(["set-mute", "@DEFAULT_AUDIO_SINK@", "0"])
@@ -89,6 +198,17 @@ impl AudioGuard {
         }
     }
 
+    #[cfg(not(any(target_os = "macos", target_os = "linux")))]
+    fn is_muted_cmd() -> Option<bool> {
+        None
+    }
+
+    #[cfg(not(any(target_os = "macos", target_os = "linux")))]
+    fn mute_cmd() {}
+
+    #[cfg(not(any(target_os = "macos", target_os = "linux")))]
+    fn unmute_cmd() {}
+
     #[cfg(target_os = "linux")]
     fn is_wayland() -> bool {
         env::var("XDG_SESSION_TYPE")
@@ -106,13 +226,25 @@ impl AudioGuard {
     }
 }
 
+impl Drop for AudioGuard {
+    fn drop(&mut self) {
+        self.release();
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
 
     #[test]
     fn test_mute_unmute_doesnt_panic() {
-        AudioGuard::mute();
-        AudioGuard::unmute();
+        let guard = AudioGuard::mute();
+        guard.unmute();
+    }
+
+    #[test]
+    fn test_drop_releases_guard() {
+        let guard = AudioGuard::mute();
+        drop(guard);
     }
 }
@@ -0,0 +1,341 @@
+// Copyright 2026 a7mddra
+// SPDX-License-Identifier: Apache-2.0
+
+//! Minimal PulseAudio client, loaded at runtime
+//!
+//! Talks the native protocol through libpulse, which PipeWire serves as
+//! well (pipewire-pulse), so muting the sink costs a socket round trip
+//! instead of spawning `wpctl`/`pactl`. The library is `dlopen`ed so the
+//! binary keeps no link-time dependency on it; callers fall back to the
+//! command-line tools when it is missing or no server answers.
+
+use std::ffi::{c_char, c_int, c_void, CStr, CString};
+use std::ptr;
+use std::sync::OnceLock;
+use std::time::{Duration, Instant};
+
+const CONTEXT_NOAUTOSPAWN: c_int = 1;
+const CONTEXT_READY: c_int = 4;
+const CONTEXT_FAILED: c_int = 5;
+const CONTEXT_TERMINATED: c_int = 6;
+const OPERATION_RUNNING: c_int = 0;
+
+/// Upper bound for one mainloop poll, so deadlines are honoured.
+const POLL_SLICE_USEC: c_int = 20_000;
+
+#[repr(C)]
+struct SampleSpec {
+    format: c_int,
+    rate: u32,
+    channels: u8,
+}
+
+#[repr(C)]
+struct ChannelMap {
+    channels: u8,
+    map: [c_int; 32],
+}
+
+#[repr(C)]
+struct CVolume {
+    channels: u8,
+    values: [u32; 32],
+}
+
+/// Leading fields of `pa_server_info` (ABI-stable since 0.9).
+#[repr(C)]
+struct ServerInfo {
+    user_name: *const c_char,
+    host_name: *const c_char,
+    server_version: *const c_char,
+    server_name: *const c_char,
+    sample_spec: SampleSpec,
+    default_sink_name: *const c_char,
+}
+
+/// Leading fields of `pa_sink_info`, up to `mute` (ABI-stable since 0.9).
+#[repr(C)]
+struct SinkInfo {
+    name: *const c_char,
+    index: u32,
+    description: *const c_char,
+    sample_spec: SampleSpec,
+    channel_map: ChannelMap,
+    owner_module: u32,
+    volume: CVolume,
+    mute: c_int,
+}
+
+type ServerInfoCb = extern "C" fn(*mut c_void, *const ServerInfo, *mut c_void);
+type SinkInfoCb = extern "C" fn(*mut c_void, *const SinkInfo, c_int, *mut c_void);
+type SuccessCb = extern "C" fn(*mut c_void, c_int, *mut c_void);
+
+struct Lib {
+    mainloop_new: unsafe extern "C" fn() -> *mut c_void,
+    mainloop_free: unsafe extern "C" fn(*mut c_void),
+    mainloop_get_api: unsafe extern "C" fn(*mut c_void) -> *mut c_void,
+    mainloop_prepare: unsafe extern "C" fn(*mut c_void, c_int) -> c_int,
+    mainloop_poll: unsafe extern "C" fn(*mut c_void) -> c_int,
+    mainloop_dispatch: unsafe extern "C" fn(*mut c_void) -> c_int,
+    context_new: unsafe extern "C" fn(*mut c_void, *const c_char) -> *mut c_void,
+    context_connect: unsafe extern "C" fn(*mut c_void, *const c_char, c_int, *const c_void) -> c_int,
+    context_get_state: unsafe extern "C" fn(*mut c_void) -> c_int,
+    context_disconnect: unsafe extern "C" fn(*mut c_void),
+    context_unref: unsafe extern "C" fn(*mut c_void),
+    context_get_server_info: unsafe extern "C" fn(*mut c_void, ServerInfoCb, *mut c_void) -> *mut c_void,
+    context_get_sink_info_by_name:
+        unsafe extern "C" fn(*mut c_void, *const c_char, SinkInfoCb, *mut c_void) -> *mut c_void,
+    context_set_sink_mute_by_name:
+        unsafe extern "C" fn(*mut c_void, *const c_char, c_int, SuccessCb, *mut c_void) -> *mut c_void,
+    operation_get_state: unsafe extern "C" fn(*mut c_void) -> c_int,
+    operation_unref: unsafe extern "C" fn(*mut c_void),
+}
+
+// Only immutable function pointers into a library that is never unloaded.
+unsafe impl Send for Lib {}
+unsafe impl Sync for Lib {}
+
+static LIB: OnceLock<Option<Lib>> = OnceLock::new();
+
+fn lib() -> Option<&'static Lib> {
+    LIB.get_or_init(|| unsafe { load() }).as_ref()
+}
+
+unsafe fn load() -> Option<Lib> {
+    let handle = libc::dlopen(c"libpulse.so.0".as_ptr(), libc::RTLD_NOW | libc::RTLD_LOCAL);
+    if handle.is_null() {
+        return None;
+    }
+
+    macro_rules! sym {
+        ($name:literal) => {{
+            let f = libc::dlsym(handle, $name.as_ptr());
+            if f.is_null() {
+                return None;
+            }
+            std::mem::transmute(f)
+        }};
+    }
+
+    Some(Lib {
+        mainloop_new: sym!(c"pa_mainloop_new"),
+        mainloop_free: sym!(c"pa_mainloop_free"),
+        mainloop_get_api: sym!(c"pa_mainloop_get_api"),
+        mainloop_prepare: sym!(c"pa_mainloop_prepare"),
+        mainloop_poll: sym!(c"pa_mainloop_poll"),
+        mainloop_dispatch: sym!(c"pa_mainloop_dispatch"),
+        context_new: sym!(c"pa_context_new"),
+        context_connect: sym!(c"pa_context_connect"),
+        context_get_state: sym!(c"pa_context_get_state"),
+        context_disconnect: sym!(c"pa_context_disconnect"),
+        context_unref: sym!(c"pa_context_unref"),
+        context_get_server_info: sym!(c"pa_context_get_server_info"),
+        context_get_sink_info_by_name: sym!(c"pa_context_get_sink_info_by_name"),
+        context_set_sink_mute_by_name: sym!(c"pa_context_set_sink_mute_by_name"),
+        operation_get_state: sym!(c"pa_operation_get_state"),
+        operation_unref: sym!(c"pa_operation_unref"),
+    })
+}
+
+extern "C" fn on_server_info(_: *mut c_void, info: *const ServerInfo, userdata: *mut c_void) {
+    let out = unsafe { &mut *(userdata as *mut Option<String>) };
+    if let Some(info) = unsafe { info.as_ref() } {
+        if !info.default_sink_name.is_null() {
+            let name = unsafe { CStr::from_ptr(info.default_sink_name) };
+            *out = Some(name.to_string_lossy().into_owned());
+        }
+    }
+}
+
+extern "C" fn on_sink_info(_: *mut c_void, info: *const SinkInfo, eol: c_int, userdata: *mut c_void) {
+    let out = unsafe { &mut *(userdata as *mut Option<bool>) };
+    if eol == 0 {
+        if let Some(info) = unsafe { info.as_ref() } {
+            *out = Some(info.mute != 0);
+        }
+    }
+}
+
+extern "C" fn on_success(_: *mut c_void, success: c_int, userdata: *mut c_void) {
+    let out = unsafe { &mut *(userdata as *mut bool) };
+    *out = success != 0;
+}
+
+/// One connection to the sound server on a private mainloop.
+pub(crate) struct Client {
+    lib: &'static Lib,
+    mainloop: *mut c_void,
+    context: *mut c_void,
+    timeout: Duration,
+    deadline: Instant,
+}
+
+impl Client {
+    /// Connects without autospawning a server. `timeout` bounds the
+    /// connection and, separately, each later request.
+    pub fn connect(timeout: Duration) -> Option<Self> {
+        let lib = lib()?;
+        let mainloop = unsafe { (lib.mainloop_new)() };
+        if mainloop.is_null() {
+            return None;
+        }
+
+        let api = unsafe { (lib.mainloop_get_api)(mainloop) };
+        let context = unsafe { (lib.context_new)(api, c"capture-engine".as_ptr()) };
+        let client = Self {
+            lib,
+            mainloop,
+            context,
+            timeout,
+            deadline: Instant::now() + timeout,
+        };
+        if context.is_null() {
+            return None;
+        }
+
+        let rc = unsafe { (lib.context_connect)(context, ptr::null(), CONTEXT_NOAUTOSPAWN, ptr::null()) };
+        if rc < 0 {
+            return None;
+        }
+
+        loop {
+            match unsafe { (lib.context_get_state)(context) } {
+                CONTEXT_READY => return Some(client),
+                CONTEXT_FAILED | CONTEXT_TERMINATED => return None,
+                _ => {
+                    if !client.iterate() {
+                        return None;
+                    }
+                }
+            }
+        }
+    }
+
+    pub fn default_sink(&mut self) -> Option<String> {
+        self.rearm();
+        let mut name: Option<String> = None;
+        let op = unsafe {
+            (self.lib.context_get_server_info)(self.context, on_server_info, &mut name as *mut _ as *mut c_void)
+        };
+        self.wait(op).then_some(())?;
+        name
+    }
+
+    pub fn sink_muted(&mut self, sink: &str) -> Option<bool> {
+        self.rearm();
+        let sink = CString::new(sink).ok()?;
+        let mut muted: Option<bool> = None;
+        let op = unsafe {
+            (self.lib.context_get_sink_info_by_name)(
+                self.context,
+                sink.as_ptr(),
+                on_sink_info,
+                &mut muted as *mut _ as *mut c_void,
+            )
+        };
+        self.wait(op).then_some(())?;
+        muted
+    }
+
+    pub fn set_sink_muted(&mut self, sink: &str, mute: bool) -> bool {
+        self.rearm();
+        let Ok(sink) = CString::new(sink) else { return false };
+        let mut ok = false;
+        let op = unsafe {
+            (self.lib.context_set_sink_mute_by_name)(
+                self.context,
+                sink.as_ptr(),
+                mute as c_int,
+                on_success,
+                &mut ok as *mut _ as *mut c_void,
+            )
+        };
+        self.wait(op) && ok
+    }
+
+    fn rearm(&mut self) {
+        self.deadline = Instant::now() + self.timeout;
+    }
+
+    /// Runs the mainloop until `op` completes; its callback has fired then.
+    fn wait(&self, op: *mut c_void) -> bool {
+        if op.is_null() {
+            return false;
+        }
+        let mut done = true;
+        while unsafe { (self.lib.operation_get_state)(op) } == OPERATION_RUNNING {
+            if !self.iterate() {
+                done = false;
+                break;
+            }
+        }
+        unsafe { (self.lib.operation_unref)(op) };
+        done
+    }
+
+    /// One bounded poll/dispatch round; false past the deadline or on error.
+    fn iterate(&self) -> bool {
+        if Instant::now() >= self.deadline {
+            return false;
+        }
+        unsafe {
+            (self.lib.mainloop_prepare)(self.mainloop, POLL_SLICE_USEC) >= 0
+                && (self.lib.mainloop_poll)(self.mainloop) >= 0
+                && (self.lib.mainloop_dispatch)(self.mainloop) >= 0
+        }
+    }
+}
+
+impl Drop for Client {
+    fn drop(&mut self) {
+        unsafe {
+            if !self.context.is_null() {
+                (self.lib.context_disconnect)(self.context);
+                (self.lib.context_unref)(self.context);
+            }
+            (self.lib.mainloop_free)(self.mainloop);
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::process::Command;
+
+    #[test]
+    #[cfg(target_pointer_width = "64")]
+    fn test_struct_prefixes_match_libpulse_abi() {
+        assert_eq!(std::mem::offset_of!(ServerInfo, default_sink_name), 48);
+        assert_eq!(std::mem::offset_of!(SinkInfo, volume), 172);
+        assert_eq!(std::mem::offset_of!(SinkInfo, mute), 304);
+    }
+
+    /// Needs a running PipeWire (pipewire-pulse) or PulseAudio daemon and
+    /// `pactl`: `cargo test -p sys-shutter-suppressor -- --ignored`.
+    #[test]
+    #[ignore]
+    fn test_mute_roundtrip_on_null_sink() {
+        let Some(mut client) = Client::connect(Duration::from_secs(2)) else {
+            eprintln!("no sound server reachable; skipping");
+            return;
+        };
+
+        let module = Command::new("pactl")
+            .args(["load-module", "module-null-sink", "sink_name=capture_engine_test"])
+            .output()
+            .expect("pactl");
+        let module = String::from_utf8_lossy(&module.stdout).trim().to_string();
+
+        let sink = "capture_engine_test";
+        assert!(client.set_sink_muted(sink, false));
+        assert_eq!(client.sink_muted(sink), Some(false));
+        assert!(client.set_sink_muted(sink, true));
+        assert_eq!(client.sink_muted(sink), Some(true));
+        assert!(client.set_sink_muted(sink, false));
+        assert_eq!(client.sink_muted(sink), Some(false));
+        assert!(client.default_sink().is_some());
+
+        let _ = Command::new("pactl").args(["unload-module", &module]).output();
+    }
+}
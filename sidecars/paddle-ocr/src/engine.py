@@ -17,6 +17,7 @@ import logging
 from pathlib import Path
 from typing import List, Optional
 
+import numpy as np
 from paddleocr import PaddleOCR
 
 from .models import OCRResult, BoundingBox
@@ -101,6 +102,32 @@ class OCREngine:
         
         return self._parse_results(result)
     
+    def warm_up(self) -> None:
+        """
+        Load the PaddleOCR models now instead of on the first request.
+        
+        Used by the long-lived worker so the first capture does not pay
+        for model initialization.
+        """
+        self._get_ocr()
+    
+    def process_array(self, image: np.ndarray) -> List[OCRResult]:
+        """
+        Process an in-memory image and extract text with bounding boxes.
+        
+        @param image HxWx3 uint8 array in BGR channel order.
+        @return List of OCRResult objects containing text and coordinates.
+        @raises RuntimeError If OCR processing fails.
+        """
+        ocr = self._get_ocr()
+        
+        try:
+            result = ocr.ocr(image, cls=self.config.use_angle_cls)
+        except Exception as e:
+            raise RuntimeError(f"OCR processing failed: {e}") from e
+        
+        return self._parse_results(result)
+    
     def _parse_results(self, raw_result) -> List[OCRResult]:
         """
         Parse raw PaddleOCR output into structured results.
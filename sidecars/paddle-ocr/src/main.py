@@ -6,9 +6,10 @@
 OCR Engine - Command-line and IPC interface for text extraction.
 
 This is the main entry point for the OCR engine executable.
-It supports two modes:
+It supports three modes:
 1. CLI mode: ocr-engine <image_path>
 2. IPC mode: reads JSON from stdin (for Tauri integration)
+3. Worker mode: ocr-engine --serve <socket_path> (warm engine on a Unix socket)
 
 @author a7mddra
 @version 2.0.0
@@ -20,6 +21,9 @@ It supports two modes:
     # IPC mode (stdin JSON)
     echo '{"type":"path","data":"/path/to/image.png"}' | ocr-engine
     echo '{"type":"base64","data":"iVBORw0KGgo..."}' | ocr-engine
+    
+    # Worker mode (see src/server.py for the wire format)
+    ocr-engine --serve /run/user/1000/ocr-engine.sock
 """
 
 import sys
@@ -143,12 +147,16 @@ def main() -> int:
     Main entry point for the OCR engine.
     
     Determines mode based on command-line arguments:
+    - --serve <socket>: Worker mode (long-lived Unix socket server)
     - With args: CLI mode (process file path)
     - Without args: IPC mode (read from stdin)
     
     @return Exit code (0 for success, 1 for error).
     """
-    if len(sys.argv) >= 2:
+    if len(sys.argv) >= 3 and sys.argv[1] == "--serve":
+        from src.server import serve
+        return serve(sys.argv[2])
+    elif len(sys.argv) >= 2:
         return process_path(sys.argv[1])
     else:
         return process_stdin()
@@ -0,0 +1,167 @@
+# Copyright 2026 a7mddra
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Long-lived OCR worker listening on a Unix domain socket.
+
+Keeps one warm OCREngine so captures skip process start-up and model
+loading. The capture process streams the committed crop as soon as it
+exists and receives the results while it tears down its overlay.
+
+Wire format (all lengths are 4-byte big-endian):
+
+    request:  <len><header JSON><payload>
+              header = {"format": "bgra8888" | "png",
+                        "width": int, "height": int,
+                        "stride": int, "size": int}
+    response: <len><JSON>
+              {"results": [...], "timings": {"decode_ms": float, "ocr_ms": float}}
+              or {"error": "..."}
+
+@author a7mddra
+@version 1.0.0
+"""
+
+import json
+import os
+import socket
+import struct
+import time
+from typing import Optional
+
+import cv2
+import numpy as np
+
+from .engine import OCREngine
+from .models import NumpyEncoder
+
+
+def _recv_exact(conn: socket.socket, size: int) -> Optional[bytes]:
+    """
+    Read exactly size bytes from the connection.
+    
+    @param conn Connected socket.
+    @param size Number of bytes to read.
+    @return The bytes read, or None if the peer closed early.
+    """
+    chunks = []
+    remaining = size
+    while remaining > 0:
+        chunk = conn.recv(min(remaining, 1 << 20))
+        if not chunk:
+            return None
+        chunks.append(chunk)
+        remaining -= len(chunk)
+    return b"".join(chunks)
+
+
+def _send_json(conn: socket.socket, payload: dict) -> None:
+    """
+    Send a length-prefixed JSON message.
+    
+    @param conn Connected socket.
+    @param payload JSON-serializable message.
+    """
+    data = json.dumps(payload, cls=NumpyEncoder).encode("utf-8")
+    conn.sendall(struct.pack(">I", len(data)) + data)
+
+
+def _decode(header: dict, payload: bytes) -> np.ndarray:
+    """
+    Turn a request payload into a BGR image array.
+    
+    @param header Request header.
+    @param payload Raw or encoded image bytes.
+    @return HxWx3 uint8 BGR array.
+    @raises ValueError If the format is unknown or the payload is malformed.
+    """
+    fmt = header.get("format", "")
+    
+    if fmt == "bgra8888":
+        width = int(header["width"])
+        height = int(header["height"])
+        stride = int(header.get("stride", width * 4))
+        rows = np.frombuffer(payload, dtype=np.uint8, count=stride * height)
+        image = rows.reshape(height, stride)[:, : width * 4].reshape(height, width, 4)
+        return np.ascontiguousarray(image[:, :, :3])
+    
+    if fmt == "png":
+        image = cv2.imdecode(np.frombuffer(payload, dtype=np.uint8), cv2.IMREAD_COLOR)
+        if image is None:
+            raise ValueError("Failed to decode PNG payload")
+        return image
+    
+    raise ValueError(f"Unknown image format: {fmt}")
+
+
+def _handle(conn: socket.socket, engine: OCREngine) -> None:
+    """
+    Serve a single request on an accepted connection.
+    
+    @param conn Accepted connection.
+    @param engine Warm OCR engine.
+    """
+    prefix = _recv_exact(conn, 4)
+    if prefix is None:
+        return
+    
+    header_bytes = _recv_exact(conn, struct.unpack(">I", prefix)[0])
+    if header_bytes is None:
+        return
+    
+    try:
+        header = json.loads(header_bytes)
+        payload = _recv_exact(conn, int(header["size"]))
+        if payload is None:
+            return
+        
+        started = time.perf_counter()
+        image = _decode(header, payload)
+        decoded = time.perf_counter()
+        results = engine.process_array(image)
+        finished = time.perf_counter()
+        
+        _send_json(conn, {
+            "results": [result.to_dict() for result in results],
+            "timings": {
+                "decode_ms": (decoded - started) * 1000.0,
+                "ocr_ms": (finished - decoded) * 1000.0,
+            },
+        })
+    except Exception as e:
+        _send_json(conn, {"error": str(e)})
+
+
+def serve(socket_path: str) -> int:
+    """
+    Run the OCR worker until interrupted.
+    
+    @param socket_path Filesystem path of the Unix socket to listen on.
+    @return Exit code (0 on clean shutdown, 1 on error).
+    """
+    engine = OCREngine()
+    engine.warm_up()
+    
+    if os.path.exists(socket_path):
+        os.unlink(socket_path)
+    
+    server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    try:
+        server.bind(socket_path)
+        os.chmod(socket_path, 0o600)
+        server.listen(4)
+        print(json.dumps({"ready": socket_path}), flush=True)
+        
+        while True:
+            conn, _ = server.accept()
+            with conn:
+                _handle(conn, engine)
+    except KeyboardInterrupt:
+        return 0
+    except Exception as e:
+        print(json.dumps({"error": str(e)}), flush=True)
+        return 1
+    finally:
+        server.close()
+        if os.path.exists(socket_path):
+            os.unlink(socket_path)
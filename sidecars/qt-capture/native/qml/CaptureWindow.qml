@@ -33,6 +33,7 @@ Window {
     color: "transparent"
     
     required property var controller
+    property var governor: null
     
     Image {
         id: background
@@ -73,6 +74,7 @@ Window {
         onLoaded: {
             if (item) {
                 item.controller = root.controller
+                item.governor = root.governor
                 item.forceActiveFocus()
             }
         }
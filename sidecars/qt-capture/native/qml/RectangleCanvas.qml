@@ -12,6 +12,10 @@ import Qt5Compat.GraphicalEffects
  * - 65% brightness dim overlay outside selection
  * - Gradient stroke for shine/sparkle effect
  * - Smooth outer glow
+ * - Hover snapping: the window under the cursor is outlined and a plain
+ *   click (no drag) commits its exact geometry
+ * - Glow cost follows the QualityGovernor level; the selection path and
+ *   dim cut-out are drawn the same at every level
  */
 
 Item {
@@ -20,11 +24,19 @@ Item {
     focus: true
     
     property var controller
+    property var governor: null
+    
+    // 2 = full, 1 = reduced, 0 = no glow (see QualityGovernor)
+    readonly property int quality: governor ? governor.level : 2
     
     property point startPoint: Qt.point(0, 0)
     property point endPoint: Qt.point(0, 0)
     property bool isDrawing: false
     property bool hasSelection: false
+    property rect hoverRect: Qt.rect(0, 0, 0, 0)
+    
+    readonly property real clickThreshold: 4
+    readonly property bool hasHoverRect: hoverRect.width > 0 && hoverRect.height > 0
     
     readonly property real selX: Math.min(startPoint.x, endPoint.x)
     readonly property real selY: Math.min(startPoint.y, endPoint.y)
@@ -185,7 +197,7 @@ Item {
     Item {
         id: glowWrapper
         anchors.fill: parent
-        visible: selectionBorderCanvas.visible
+        visible: selectionBorderCanvas.visible && root.quality > 0
         opacity: root.glowIntensity
         
         Behavior on opacity {
@@ -198,8 +210,8 @@ Item {
         Glow {
             anchors.fill: selectionBorderCanvas
             source: selectionBorderCanvas
-            radius: 48 * root.glowIntensity
-            samples: 64
+            radius: (root.quality > 1 ? 48 : 16) * root.glowIntensity
+            samples: root.quality > 1 ? 64 : 24
             color: Qt.rgba(255, 255, 255, 0.6)
             spread: 0.0
             transparentBorder: true
@@ -216,7 +228,7 @@ Item {
             anchors.fill: selectionBorderCanvas
             source: selectionBorderCanvas
             radius: 20 * root.glowIntensity
-            samples: 32
+            samples: root.quality > 1 ? 32 : 16
             color: Qt.rgba(255, 255, 255, 0.8)
             spread: 0.15
             transparentBorder: true
@@ -239,12 +251,24 @@ Item {
             transparentBorder: true
         }
         
-        layer.enabled: true
+        layer.enabled: visible
         layer.effect: OpacityMask {
             maskSource: glowMask
         }
     }
 
+    Rectangle {
+        id: hoverHighlight
+        visible: root.hasHoverRect && !root.isDrawing && !root.hasSelection
+        x: root.hoverRect.x
+        y: root.hoverRect.y
+        width: root.hoverRect.width
+        height: root.hoverRect.height
+        color: Qt.rgba(1, 1, 1, 0.08)
+        border.width: 2
+        border.color: Qt.rgba(1, 1, 1, 0.85)
+    }
+
     MouseArea {
         id: mouseArea
         anchors.fill: parent
@@ -256,17 +280,30 @@ Item {
             root.endPoint = root.startPoint
             root.isDrawing = true
             root.hasSelection = false
+            root.controller.beginSelection()
         }
         
         onPositionChanged: function(mouse) {
             if (root.isDrawing) {
                 root.endPoint = Qt.point(mouse.x, mouse.y)
+            } else {
+                root.hoverRect = root.controller.windowRectAt(mouse.x, mouse.y)
             }
         }
         
         onReleased: function(mouse) {
             if (root.isDrawing) {
-                root.endPoint = Qt.point(mouse.x, mouse.y)
+                var isClick = Math.abs(mouse.x - root.startPoint.x) < root.clickThreshold
+                           && Math.abs(mouse.y - root.startPoint.y) < root.clickThreshold
+                
+                if (isClick && root.hasHoverRect) {
+                    root.startPoint = Qt.point(root.hoverRect.x, root.hoverRect.y)
+                    root.endPoint = Qt.point(root.hoverRect.x + root.hoverRect.width,
+                                             root.hoverRect.y + root.hoverRect.height)
+                } else {
+                    root.endPoint = Qt.point(mouse.x, mouse.y)
+                }
+                
                 root.isDrawing = false
                 root.hasSelection = true
                 root.controller.finishRectCapture(root.startPoint, root.endPoint)
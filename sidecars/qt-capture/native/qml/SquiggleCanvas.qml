@@ -9,6 +9,7 @@ import Qt5Compat.GraphicalEffects
  * 
  * This is the "Circle to Search" style squiggle selection mode.
  * Uses quadratic bezier curves for smooth paths and Glow for the effect.
+ * The glow follows the QualityGovernor level; the stroke itself never does.
  */
 
 Item {
@@ -17,6 +18,10 @@ Item {
     focus: true
     
     property var controller
+    property var governor: null
+    
+    // 2 = full, 1 = reduced, 0 = no glow (see QualityGovernor)
+    readonly property int quality: governor ? governor.level : 2
     
     property var strokes: []
     property bool isDrawing: false
@@ -79,8 +84,9 @@ Item {
     Glow {
         anchors.fill: canvas
         source: canvas
-        radius: 12
-        samples: 25
+        visible: root.quality > 0
+        radius: root.quality > 1 ? 12 : 6
+        samples: root.quality > 1 ? 25 : 13
         color: Qt.rgba(1, 1, 1, 0.5)
         spread: 0.2
         cached: false
@@ -100,6 +106,7 @@ Item {
             root.currentMouse = Qt.point(mouse.x, mouse.y)
             root.strokes.push({x: mouse.x, y: mouse.y})
             canvas.requestPaint()
+            root.controller.beginSelection()
         }
         
         onPositionChanged: function(mouse) {
@@ -0,0 +1,296 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "capture_core.h"
+#include "FrameOps.h"
+#include "FramePool.h"
+#include "ScreenGrabber.h"
+#include <QGuiApplication>
+#include <QScreen>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+extern "C" ScreenGrabber *createWindowsEngine(QObject *parent);
+extern "C" ScreenGrabber *createUnixEngine(QObject *parent);
+
+struct cc_session
+{
+    std::vector<CapturedFrame> frames;
+};
+
+namespace
+{
+bool ensureApplication()
+{
+    if (QGuiApplication::instance())
+        return true;
+
+#ifdef Q_OS_LINUX
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "xcb");
+#endif
+
+    static int argc = 1;
+    static char name[] = "capture_core";
+    static char *argv[] = {name, nullptr};
+    new QGuiApplication(argc, argv);
+    return QGuiApplication::instance() != nullptr;
+}
+
+ScreenGrabber *engine()
+{
+    static std::unique_ptr<ScreenGrabber> instance;
+    if (!instance)
+    {
+#ifdef Q_OS_WIN
+        instance.reset(createWindowsEngine(nullptr));
+#else
+        instance.reset(createUnixEngine(nullptr));
+#endif
+    }
+    return instance.get();
+}
+
+void fillInfo(cc_frame_info *out, const QRect &geometry, qreal dpr, int index, const QSize &pixels, const QString &name)
+{
+    out->x = geometry.x();
+    out->y = geometry.y();
+    out->width = geometry.width();
+    out->height = geometry.height();
+    out->device_pixel_ratio = dpr;
+    out->index = index;
+    out->pixel_width = pixels.width();
+    out->pixel_height = pixels.height();
+
+    const QByteArray utf8 = name.toUtf8().left(CC_NAME_LENGTH - 1);
+    memset(out->name, 0, sizeof(out->name));
+    memcpy(out->name, utf8.constData(), size_t(utf8.size()));
+}
+
+// Formats whose 32-bit words are 0xAARRGGBB; written as they are.
+const std::vector<QImage::Format> kNativeFormats = {
+    QImage::Format_RGB32,
+    QImage::Format_ARGB32,
+    QImage::Format_ARGB32_Premultiplied,
+};
+
+bool fits(const cc_frame_buffer &buffer, const QImage &image)
+{
+    return buffer.data && buffer.stride >= size_t(image.width()) * 4
+        && buffer.size >= buffer.stride * size_t(image.height());
+}
+
+void copyInto(cc_frame_buffer &buffer, const QImage &image)
+{
+    const QImage source = std::find(kNativeFormats.begin(), kNativeFormats.end(), image.format()) != kNativeFormats.end()
+        ? image
+        : image.convertToFormat(QImage::Format_RGB32);
+
+    const size_t rowBytes = size_t(source.width()) * 4;
+    for (int y = 0; y < source.height(); ++y)
+        memcpy(buffer.data + size_t(y) * buffer.stride, source.constScanLine(y), rowBytes);
+}
+
+const CapturedFrame *frameAt(const cc_session *session, int32_t index)
+{
+    if (!session || index < 0 || size_t(index) >= session->frames.size())
+        return nullptr;
+    return &session->frames[size_t(index)];
+}
+}
+
+uint32_t cc_abi_version(void)
+{
+    return CC_ABI_VERSION;
+}
+
+int32_t cc_enumerate_screens(cc_frame_info *out, int32_t capacity)
+{
+    if (!ensureApplication())
+        return CC_ERR_INIT;
+
+    const QList<QScreen *> screens = QGuiApplication::screens();
+    for (int i = 0; out && i < screens.size() && i < capacity; ++i)
+    {
+        QScreen *s = screens[i];
+        const qreal dpr = s->devicePixelRatio();
+        fillInfo(&out[i], s->geometry(), dpr, i, (QSizeF(s->geometry().size()) * dpr).toSize(), s->name());
+    }
+    return int32_t(screens.size());
+}
+
+cc_status cc_capture(cc_session **out)
+{
+    if (!out)
+        return CC_ERR_ARGUMENT;
+    *out = nullptr;
+
+    if (!ensureApplication() || !engine())
+        return CC_ERR_INIT;
+
+    auto session = std::make_unique<cc_session>();
+    session->frames = engine()->captureAll();
+    if (session->frames.empty())
+        return CC_ERR_NO_FRAMES;
+
+    *out = session.release();
+    return CC_OK;
+}
+
+cc_status cc_capture_into(cc_frame_buffer *buffers, int32_t count, int32_t *frames_out)
+{
+    if (!buffers || count <= 0 || !frames_out)
+        return CC_ERR_ARGUMENT;
+    *frames_out = 0;
+
+    if (!ensureApplication() || !engine())
+        return CC_ERR_INIT;
+
+    std::vector<FramePool::Target> targets;
+    for (int32_t i = 0; i < count; ++i)
+    {
+        buffers[i].filled = 0;
+        targets.push_back({buffers[i].data, qsizetype(buffers[i].stride), buffers[i].size});
+    }
+
+    FramePool::instance().setTargets(targets, kNativeFormats);
+    std::vector<CapturedFrame> frames = engine()->captureAll();
+    FramePool::instance().setTargets({}, {});
+
+    if (frames.empty())
+        return CC_ERR_NO_FRAMES;
+
+    // First the frames the grab already wrote into a buffer; a mirrored
+    // output shares its source's pixels, so it only claims one once.
+    std::vector<bool> placed(frames.size(), false);
+    for (size_t f = 0; f < frames.size(); ++f)
+    {
+        for (int32_t i = 0; i < count; ++i)
+        {
+            if (!buffers[i].filled && frames[f].image.constBits() == buffers[i].data)
+            {
+                buffers[i].filled = 1;
+                placed[f] = true;
+                fillInfo(&buffers[i].info, frames[f].geometry, frames[f].devicePixelRatio, frames[f].index,
+                         frames[f].image.size(), frames[f].name);
+                break;
+            }
+        }
+    }
+
+    cc_status status = CC_OK;
+    for (size_t f = 0; f < frames.size(); ++f)
+    {
+        if (placed[f])
+            continue;
+
+        const CapturedFrame &frame = frames[f];
+        auto slot = std::find_if(buffers, buffers + count, [&](const cc_frame_buffer &buffer)
+                                 { return !buffer.filled && fits(buffer, frame.image); });
+        if (slot == buffers + count)
+        {
+            status = CC_ERR_BUFFER_TOO_SMALL;
+            continue;
+        }
+
+        copyInto(*slot, frame.image);
+        slot->filled = 1;
+        fillInfo(&slot->info, frame.geometry, frame.devicePixelRatio, frame.index, frame.image.size(), frame.name);
+    }
+
+    for (int32_t i = 0; i < count; ++i)
+        *frames_out += buffers[i].filled;
+    return status;
+}
+
+void cc_session_free(cc_session *session)
+{
+    delete session;
+}
+
+int32_t cc_frame_count(const cc_session *session)
+{
+    return session ? int32_t(session->frames.size()) : 0;
+}
+
+cc_status cc_frame_info_get(const cc_session *session, int32_t index, cc_frame_info *out)
+{
+    const CapturedFrame *frame = frameAt(session, index);
+    if (!frame || !out)
+        return CC_ERR_ARGUMENT;
+
+    fillInfo(out, frame->geometry, frame->devicePixelRatio, frame->index, frame->image.size(), frame->name);
+    return CC_OK;
+}
+
+cc_status cc_frame_read(const cc_session *session, int32_t index, uint8_t *dst, size_t dst_stride, size_t dst_size)
+{
+    const CapturedFrame *frame = frameAt(session, index);
+    if (!frame || !dst)
+        return CC_ERR_ARGUMENT;
+
+    const size_t rowBytes = size_t(frame->image.width()) * 4;
+    if (dst_stride < rowBytes || dst_size < dst_stride * size_t(frame->image.height()))
+        return CC_ERR_BUFFER_TOO_SMALL;
+
+    const QImage source = frame->image.format() == QImage::Format_RGBA8888
+        ? frame->image
+        : frame->image.convertToFormat(QImage::Format_RGBA8888);
+
+    for (int y = 0; y < source.height(); ++y)
+        memcpy(dst + size_t(y) * dst_stride, source.constScanLine(y), rowBytes);
+
+    return CC_OK;
+}
+
+cc_status cc_crop_encode(const cc_session *session, int32_t index,
+                         double x, double y, double width, double height,
+                         const char *format, uint8_t **out_data, size_t *out_size)
+{
+    const CapturedFrame *frame = frameAt(session, index);
+    if (!frame || !format || !out_data || !out_size)
+        return CC_ERR_ARGUMENT;
+
+    *out_data = nullptr;
+    *out_size = 0;
+
+    const QImage cropped = FrameOps::crop(frame->image, QRectF(x, y, width, height), frame->devicePixelRatio);
+    if (cropped.isNull())
+        return CC_ERR_ARGUMENT;
+
+    const QByteArray encoded = FrameOps::encode(cropped, format);
+    if (encoded.isEmpty())
+        return CC_ERR_ENCODE;
+
+    auto *data = static_cast<uint8_t *>(malloc(size_t(encoded.size())));
+    if (!data)
+        return CC_ERR_ENCODE;
+    memcpy(data, encoded.constData(), size_t(encoded.size()));
+
+    *out_data = data;
+    *out_size = size_t(encoded.size());
+    return CC_OK;
+}
+
+void cc_buffer_free(uint8_t *data)
+{
+    free(data);
+}
+
+cc_status cc_pool_stats_get(cc_pool_stats *out)
+{
+    if (!out)
+        return CC_ERR_ARGUMENT;
+
+    const FramePool::Stats stats = FramePool::instance().stats();
+    out->hits = stats.hits;
+    out->misses = stats.misses;
+    out->resident_bytes = stats.residentBytes;
+    out->idle_bytes = stats.idleBytes;
+    return CC_OK;
+}
@@ -0,0 +1,128 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CAPTURE_CORE_H
+#define CAPTURE_CORE_H
+
+/*
+ * Stable C ABI of the capture core: enumerate screens, grab them into
+ * caller-provided buffers, crop and encode in memory. Lets hosts capture
+ * in-process instead of spawning capture-bin and reading files back.
+ *
+ * All functions must be called from the same thread. A QGuiApplication is
+ * created on first use when the host does not already run one.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(CAPTURE_CORE_BUILD)
+#define CAPTURE_CORE_API __declspec(dllexport)
+#else
+#define CAPTURE_CORE_API __declspec(dllimport)
+#endif
+#else
+#define CAPTURE_CORE_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CC_ABI_VERSION 3u
+#define CC_NAME_LENGTH 64
+
+typedef enum cc_status
+{
+    CC_OK = 0,
+    CC_ERR_INIT = -1,
+    CC_ERR_NO_FRAMES = -2,
+    CC_ERR_ARGUMENT = -3,
+    CC_ERR_BUFFER_TOO_SMALL = -4,
+    CC_ERR_ENCODE = -5
+} cc_status;
+
+typedef struct cc_frame_info
+{
+    int32_t x; /* logical desktop geometry */
+    int32_t y;
+    int32_t width;
+    int32_t height;
+    double device_pixel_ratio;
+    int32_t index;
+    int32_t pixel_width; /* physical size of the grabbed plane */
+    int32_t pixel_height;
+    char name[CC_NAME_LENGTH]; /* UTF-8, NUL terminated */
+} cc_frame_info;
+
+typedef struct cc_pool_stats
+{
+    uint64_t hits; /* frame buffers served from the pool */
+    uint64_t misses;
+    uint64_t resident_bytes; /* pooled buffers alive, idle or in use */
+    uint64_t idle_bytes;
+} cc_pool_stats;
+
+/*
+ * Caller memory for one screen, sized from cc_enumerate_screens(): at least
+ * pixel_height rows of stride >= pixel_width * 4 bytes.
+ */
+typedef struct cc_frame_buffer
+{
+    uint8_t *data;
+    size_t stride;
+    size_t size;
+    cc_frame_info info; /* out: the frame written here */
+    int32_t filled;     /* out: 1 when a frame was written */
+} cc_frame_buffer;
+
+typedef struct cc_session cc_session;
+
+CAPTURE_CORE_API uint32_t cc_abi_version(void);
+
+/* Fills up to @capacity entries (without grabbing) and returns the screen count, or < 0 on error. */
+CAPTURE_CORE_API int32_t cc_enumerate_screens(cc_frame_info *out, int32_t capacity);
+
+/* Grabs every screen. Free the session with cc_session_free(). */
+CAPTURE_CORE_API cc_status cc_capture(cc_session **out);
+CAPTURE_CORE_API void cc_session_free(cc_session *session);
+
+/*
+ * Since ABI 3: grabs every screen straight into @buffers, one per screen.
+ * Pixels are 32-bit 0xAARRGGBB words in native byte order (BGRA bytes on
+ * little-endian) with opaque alpha. The grab's own copy out of the display
+ * server writes into the buffers; backends that cannot do that are copied
+ * once more. *frames_out receives the number of buffers filled. Returns
+ * CC_ERR_BUFFER_TOO_SMALL when a frame fits no unused buffer.
+ */
+CAPTURE_CORE_API cc_status cc_capture_into(cc_frame_buffer *buffers, int32_t count, int32_t *frames_out);
+
+CAPTURE_CORE_API int32_t cc_frame_count(const cc_session *session);
+CAPTURE_CORE_API cc_status cc_frame_info_get(const cc_session *session, int32_t index, cc_frame_info *out);
+
+/* Copies a frame as 8-bit RGBA rows of @dst_stride bytes into @dst. */
+CAPTURE_CORE_API cc_status cc_frame_read(const cc_session *session, int32_t index,
+                                         uint8_t *dst, size_t dst_stride, size_t dst_size);
+
+/*
+ * Crops the logical rect of a frame and encodes it ("PNG", "JPG", ...).
+ * On success *out_data must be released with cc_buffer_free().
+ */
+CAPTURE_CORE_API cc_status cc_crop_encode(const cc_session *session, int32_t index,
+                                          double x, double y, double width, double height,
+                                          const char *format, uint8_t **out_data, size_t *out_size);
+
+CAPTURE_CORE_API void cc_buffer_free(uint8_t *data);
+
+/* Since ABI 2: counters of the process-wide frame buffer pool. */
+CAPTURE_CORE_API cc_status cc_pool_stats_get(cc_pool_stats *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAPTURE_CORE_H */
@@ -5,13 +5,90 @@
  */
 
 #include "CaptureController.h"
+#include "WindowIndex.h"
+#include "FrameOps.h"
+#include "OcrClient.h"
+#include "CodeScanner.h"
+#include "JobPool.h"
+#include "LifecycleEvents.h"
+#include "PalettePng.h"
 #include <QGuiApplication>
+#include <QWindow>
 #include <QDir>
+#include <QFileInfo>
 #include <QTemporaryFile>
 #include <QDebug>
 #include <iostream>
 #include <cmath>
 
+namespace {
+
+// The write must land before CAPTURE_SUCCESS.
+constexpr auto kWriteDeadline = std::chrono::milliseconds(500);
+
+// The preview is for an instant thumbnail in the host, so it only has to
+// beat the full write: small, lightly compressed, and never dropped.
+constexpr int kPreviewEdge = 512;
+constexpr int kPreviewQuality = 80; // Qt maps this to zlib level 1
+constexpr auto kPreviewDeadline = std::chrono::milliseconds(50);
+
+// Nearest-neighbour to twice the target, then a smooth pass: the smooth
+// scaler's cost follows the source size, so it only sees a small image.
+QImage downscale(const QImage &image, int edge)
+{
+    QSize target = image.size();
+    target.scale(edge, edge, Qt::KeepAspectRatio);
+    QImage source = image;
+    if (source.width() > 2 * target.width())
+        source = source.scaled(2 * target.width(), 2 * target.height(), Qt::IgnoreAspectRatio, Qt::FastTransformation);
+    return source.scaled(target, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+
+// Size-optimized output tries a lossless palette first. The histogram gives
+// up at the 257th colour, so truecolour crops only pay for the rows it
+// scanned before falling back to the regular encoder.
+bool writePng(const QImage &image, const QString &path, bool sizeOptimized)
+{
+    QImage output = image;
+    output.setDevicePixelRatio(1.0);
+    if (!sizeOptimized)
+        return output.save(path, "PNG", -1);
+
+    QElapsedTimer timer;
+    timer.start();
+    QVector<QRgb> palette;
+    const bool indexed = PalettePng::histogram(output, palette);
+    const double histogramMs = timer.nsecsElapsed() / 1e6;
+
+    timer.restart();
+    bool ok = indexed && PalettePng::write(output, palette, path);
+    if (!ok)
+        ok = output.save(path, "PNG", -1);
+    const double encodeMs = timer.nsecsElapsed() / 1e6;
+
+    if (indexed)
+        qDebug() << "[CaptureController] Indexed PNG," << palette.size() << "colours";
+    else
+        qDebug() << "[CaptureController] Truecolour PNG (more than" << PalettePng::kMaxColors << "colours)";
+    qDebug() << "[CaptureController] Histogram" << histogramMs << "ms, encode" << encodeMs
+             << "ms," << QFileInfo(path).size() << "bytes";
+    return ok;
+}
+
+void postEncodeDone(bool ok, const QString &path, double encodeMs)
+{
+    if (!LifecycleEvents::isEnabled())
+        return;
+    LifecycleEvents::post("encode_done", {
+        {"ok", ok},
+        {"path", path},
+        {"encode_ms", encodeMs},
+        {"bytes", ok ? QFileInfo(path).size() : 0},
+    });
+}
+
+} // namespace
+
 CaptureController::CaptureController(QObject *parent)
     : QObject(parent)
 {
@@ -59,11 +136,24 @@ void CaptureController::setDisplayIndex(int index)
 void CaptureController::cancel()
 {
     qDebug() << "[CaptureController] Capture cancelled";
-    emitFailure();
+    fail("cancelled");
+}
+
+void CaptureController::beginSelection()
+{
+    LifecycleEvents::post("selection_started", {
+        {"display", m_displayIndex},
+        {"mode", m_captureMode},
+    });
 }
 
 void CaptureController::finishSquiggleCapture(const QVariantList &points)
 {
+    if (m_committed)
+        return;
+    
+    m_releaseClock.start();
+    
     if (points.isEmpty())
     {
         qWarning() << "[CaptureController] No points provided for squiggle capture";
@@ -102,6 +192,11 @@ void CaptureController::finishSquiggleCapture(const QVariantList &points)
 
 void CaptureController::finishRectCapture(QPointF start, QPointF end)
 {
+    if (m_committed)
+        return;
+    
+    m_releaseClock.start();
+    
     QRectF selectionRect = QRectF(start, end).normalized();
     
     if (selectionRect.width() < 1 || selectionRect.height() < 1)
@@ -111,49 +206,179 @@ void CaptureController::finishRectCapture(QPointF start, QPointF end)
         return;
     }
     
+    if (m_regionHandoff)
+    {
+        const QRect bounds(QPoint(0, 0), m_screenGeometry.size());
+        const QRect region = selectionRect.toAlignedRect().intersected(bounds);
+        postCommitted(region, FrameOps::toPhysical(region, m_devicePixelRatio, m_backgroundImage.size()));
+        emit regionCommitted(region);
+        return;
+    }
+    
     std::cout << "REQ_MUTE" << std::endl;
     std::cout.flush();
     
     cropAndSave(selectionRect);
 }
 
+QRectF CaptureController::windowRectAt(qreal x, qreal y) const
+{
+    if (!m_windowIndex || m_windowIndex->isEmpty())
+        return QRectF();
+
+    // Window geometry is native; the screen origin stays native under Qt's
+    // high-DPI mapping, only the extent is scaled.
+    const QPointF origin = m_screenGeometry.topLeft();
+    const QPoint nativePos = (origin + QPointF(x, y) * m_devicePixelRatio).toPoint();
+
+    const QRect hit = m_windowIndex->hitTest(nativePos);
+    if (!hit.isValid())
+        return QRectF();
+
+    const QRectF local((hit.x() - origin.x()) / m_devicePixelRatio,
+                       (hit.y() - origin.y()) / m_devicePixelRatio,
+                       hit.width() / m_devicePixelRatio,
+                       hit.height() / m_devicePixelRatio);
+    return local.intersected(QRectF(QPointF(0, 0), QSizeF(m_screenGeometry.size())));
+}
+
+void CaptureController::postCommitted(const QRectF &logicalRect, const QRect &pixelRect)
+{
+    LifecycleEvents::post("selection_committed", {
+        {"display", m_displayIndex},
+        {"mode", m_captureMode},
+        {"rect", LifecycleEvents::rect(logicalRect)},
+        {"pixels", LifecycleEvents::rect(pixelRect)},
+        {"screen", LifecycleEvents::rect(m_screenGeometry)},
+        {"dpr", m_devicePixelRatio},
+    });
+}
+
 void CaptureController::cropAndSave(const QRectF &logicalRect)
 {
-    int physX = qRound(logicalRect.x() * m_devicePixelRatio);
-    int physY = qRound(logicalRect.y() * m_devicePixelRatio);
-    int physW = qRound(logicalRect.width() * m_devicePixelRatio);
-    int physH = qRound(logicalRect.height() * m_devicePixelRatio);
-    
-    physX = qMax(0, physX);
-    physY = qMax(0, physY);
+    // Announce the geometry before copying pixels out of the frame.
+    const QRect pixelRect = FrameOps::toPhysical(logicalRect, m_devicePixelRatio, m_backgroundImage.size());
+    if (!pixelRect.isEmpty())
+        postCommitted(logicalRect, pixelRect);
     
-    if (physX + physW > m_backgroundImage.width())
-        physW = m_backgroundImage.width() - physX;
-    if (physY + physH > m_backgroundImage.height())
-        physH = m_backgroundImage.height() - physY;
+    QImage cropped = FrameOps::crop(m_backgroundImage, logicalRect, m_devicePixelRatio);
     
-    if (physW <= 0 || physH <= 0)
+    if (cropped.isNull())
     {
         qWarning() << "[CaptureController] Invalid crop dimensions";
         emitFailure();
         return;
     }
     
-    QImage cropped = m_backgroundImage.copy(physX, physY, physW, physH);
-    cropped.setDevicePixelRatio(1.0);
+    // Start OCR before encoding so the worker overlaps PNG compression.
+    if (m_ocrClient)
+    {
+        connect(m_ocrClient, &OcrClient::finished, this, [this]()
+                {
+                    if (m_resultEmitted)
+                        exitWhenIdle();
+                });
+        m_ocrClient->submit(cropped);
+    }
+    
+    // Codes decode alongside the write; a hit makes OCR redundant.
+    if (m_codeScanner)
+    {
+        connect(m_codeScanner, &CodeScanner::finished, this, [this](bool found)
+                {
+                    if (found && m_ocrClient)
+                        m_ocrClient->cancel("code decoded");
+                    if (m_resultEmitted)
+                        exitWhenIdle();
+                });
+        m_codeScanner->submit(cropped, m_jobs);
+    }
+    
+    if (!m_jobs)
+    {
+        saveImage(cropped);
+        return;
+    }
+    
+    m_committed = true;
+    submitJobs(cropped);
+}
+
+void CaptureController::submitJobs(const QImage &cropped)
+{
+    const auto now = JobPool::Clock::now();
+    const QString finalPath = QDir::temp().filePath("spatial_capture.png");
+    
+    const bool sizeOptimized = m_sizeOptimized;
+    
+    // Queued ahead of the write, so a second worker encodes the preview
+    // while the full-size PNG is still compressing.
+    if (m_previewEnabled && qMax(cropped.width(), cropped.height()) > kPreviewEdge)
+    {
+        m_jobs->submit([this, cropped]()
+        {
+            QElapsedTimer clock;
+            clock.start();
+            const QImage preview = downscale(cropped, kPreviewEdge);
+            const QString previewPath = QDir::temp().filePath("spatial_capture_preview.png");
+            const bool ok = preview.save(previewPath, "PNG", kPreviewQuality);
+            const double encodeMs = clock.nsecsElapsed() / 1e6;
+            
+            if (!ok)
+            {
+                qWarning() << "[CaptureController] Failed to write preview";
+                return;
+            }
+            QMetaObject::invokeMethod(this, [this, previewPath, size = preview.size(), encodeMs]()
+            {
+                emitPreview(previewPath, size, encodeMs);
+            }, Qt::QueuedConnection);
+        }, now + kPreviewDeadline);
+    }
     
+    m_jobs->submit([this, cropped, finalPath, sizeOptimized]()
+    {
+        QElapsedTimer clock;
+        clock.start();
+        const bool ok = writePng(cropped, finalPath, sizeOptimized);
+        const double encodeMs = clock.nsecsElapsed() / 1e6;
+        
+        QMetaObject::invokeMethod(this, [this, ok, finalPath, encodeMs]()
+        {
+            postEncodeDone(ok, finalPath, encodeMs);
+            if (ok)
+            {
+                qDebug() << "[CaptureController] Saved capture to:" << finalPath;
+                emitSuccess(finalPath);
+            }
+            else
+            {
+                qWarning() << "[CaptureController] Failed to save cropped image";
+                emitFailure();
+            }
+        }, Qt::QueuedConnection);
+    }, now + kWriteDeadline);
+}
+
+bool CaptureController::saveImage(const QImage &image)
+{
     QString finalPath = QDir::temp().filePath("spatial_capture.png");
     
-    if (cropped.save(finalPath, "PNG", -1))
+    QElapsedTimer clock;
+    clock.start();
+    const bool ok = writePng(image, finalPath, m_sizeOptimized);
+    postEncodeDone(ok, finalPath, clock.nsecsElapsed() / 1e6);
+    
+    if (ok)
     {
         qDebug() << "[CaptureController] Saved capture to:" << finalPath;
         emitSuccess(finalPath);
+        return true;
     }
-    else
-    {
-        qWarning() << "[CaptureController] Failed to save cropped image";
-        emitFailure();
-    }
+    
+    qWarning() << "[CaptureController] Failed to save cropped image";
+    emitFailure();
+    return false;
 }
 
 void CaptureController::emitSuccess(const QString &path)
@@ -162,15 +387,75 @@ void CaptureController::emitSuccess(const QString &path)
     std::cout << path.toStdString() << std::endl;
     std::cout.flush();
     
+    if (m_releaseClock.isValid())
+        qInfo() << "[CaptureController] Release-to-result:" << m_releaseClock.nsecsElapsed() / 1e6 << "ms";
+    
+    LifecycleEvents::post("result", {
+        {"status", "success"},
+        {"path", path},
+        {"display", m_displayIndex},
+    });
+    
     emit captureCompleted(path);
-    QGuiApplication::exit(0);
+    
+    m_resultEmitted = true;
+    exitWhenIdle();
+}
+
+void CaptureController::emitPreview(const QString &path, const QSize &size, double encodeMs)
+{
+    // Too late to help once the full result is out.
+    if (m_resultEmitted)
+        return;
+    
+    std::cout << "CAPTURE_PREVIEW" << std::endl;
+    std::cout << path.toStdString() << std::endl;
+    std::cout.flush();
+    
+    qDebug() << "[CaptureController] Preview" << size << "in" << encodeMs << "ms";
+    if (m_releaseClock.isValid())
+        qInfo() << "[CaptureController] Release-to-preview:" << m_releaseClock.nsecsElapsed() / 1e6 << "ms";
+    
+    LifecycleEvents::post("preview_ready", {
+        {"path", path},
+        {"width", size.width()},
+        {"height", size.height()},
+        {"encode_ms", encodeMs},
+    });
+}
+
+void CaptureController::exitWhenIdle()
+{
+    const bool ocrPending = m_ocrClient && m_ocrClient->isPending();
+    const bool scanPending = m_codeScanner && m_codeScanner->isPending();
+    
+    if (!ocrPending && !scanPending)
+    {
+        QGuiApplication::exit(0);
+        return;
+    }
+    
+    // Tear the overlay down now; exit once the pending replies are printed.
+    QGuiApplication::setQuitOnLastWindowClosed(false);
+    for (QWindow *window : QGuiApplication::topLevelWindows())
+        window->hide();
 }
 
 void CaptureController::emitFailure()
+{
+    fail("fail");
+}
+
+void CaptureController::fail(const char *status)
 {
     std::cout << "CAPTURE_FAIL" << std::endl;
     std::cout.flush();
     
+    LifecycleEvents::post("result", {
+        {"status", status},
+        {"display", m_displayIndex},
+    });
+    
     emit captureFailed();
     QGuiApplication::exit(1);
 }
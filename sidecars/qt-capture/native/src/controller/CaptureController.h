@@ -11,11 +11,18 @@
 
 #include <QObject>
 #include <QImage>
+#include <QElapsedTimer>
 #include <QPointF>
 #include <QRectF>
 #include <QVariantList>
 #include <QUrl>
 #include <QtQml/qqml.h>
+#include <memory>
+
+class WindowIndex;
+class OcrClient;
+class CodeScanner;
+class JobPool;
 
 /**
  * @brief Bridge between QML canvas UI and C++ capture backend.
@@ -38,6 +45,17 @@ public:
     ~CaptureController() override = default;
     
     void setBackgroundImage(const QImage &image, qreal devicePixelRatio);
+    void setScreenGeometry(const QRect &geometry) { m_screenGeometry = geometry; }
+    void setWindowIndex(std::shared_ptr<const WindowIndex> index) { m_windowIndex = std::move(index); }
+    bool saveImage(const QImage &image);
+    void setRegionHandoff(bool enabled) { m_regionHandoff = enabled; }
+    void setOcrClient(OcrClient *client) { m_ocrClient = client; }
+    void setCodeScanner(CodeScanner *scanner) { m_codeScanner = scanner; }
+    void setJobPool(JobPool *pool) { m_jobs = pool; }
+    void setSizeOptimized(bool enabled) { m_sizeOptimized = enabled; }
+    void setPreviewEnabled(bool enabled) { m_previewEnabled = enabled; }
+    void emitSuccess(const QString &path);
+    void emitFailure();
     
     QUrl backgroundSource() const { return m_backgroundSource; }
     QString captureMode() const { return m_captureMode; }
@@ -46,8 +64,10 @@ public:
     void setDisplayIndex(int index);
     
     Q_INVOKABLE void cancel();
+    Q_INVOKABLE void beginSelection();
     Q_INVOKABLE void finishSquiggleCapture(const QVariantList &points);
     Q_INVOKABLE void finishRectCapture(QPointF start, QPointF end);
+    Q_INVOKABLE QRectF windowRectAt(qreal x, qreal y) const;
     
 signals:
     void backgroundSourceChanged();
@@ -55,17 +75,32 @@ signals:
     void displayIndexChanged();
     void captureCompleted(const QString &path);
     void captureFailed();
+    void regionCommitted(const QRect &logicalRect);
 
 private:
     void cropAndSave(const QRectF &logicalRect);
-    void emitSuccess(const QString &path);
-    void emitFailure();
+    void submitJobs(const QImage &cropped);
+    void emitPreview(const QString &path, const QSize &size, double encodeMs);
+    void exitWhenIdle();
+    void fail(const char *status);
+    void postCommitted(const QRectF &logicalRect, const QRect &pixelRect);
     
     QImage m_backgroundImage;
     QUrl m_backgroundSource;
     qreal m_devicePixelRatio = 1.0;
+    QRect m_screenGeometry;
+    std::shared_ptr<const WindowIndex> m_windowIndex;
     QString m_captureMode = "freeshape";
     int m_displayIndex = 0;
+    bool m_regionHandoff = false;
+    OcrClient *m_ocrClient = nullptr;
+    CodeScanner *m_codeScanner = nullptr;
+    JobPool *m_jobs = nullptr;
+    bool m_committed = false;
+    bool m_sizeOptimized = false;
+    bool m_previewEnabled = false;
+    bool m_resultEmitted = false;
+    QElapsedTimer m_releaseClock;
 };
 
 #endif // CAPTURECONTROLLER_H
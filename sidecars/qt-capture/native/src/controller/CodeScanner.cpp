@@ -0,0 +1,144 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "CodeScanner.h"
+#include "JobPool.h"
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
+#include <QDebug>
+#include <iostream>
+
+#ifdef CAPTURE_HAVE_ZXING
+#include "ReadBarcode.h"
+#endif
+
+namespace {
+
+// Decoding is only worth waiting for while the write is still running.
+constexpr auto kScanDeadline = std::chrono::milliseconds(500);
+constexpr int kMaxSymbols = 8;
+
+} // namespace
+
+CodeScanner::CodeScanner(QObject *parent)
+    : QObject(parent)
+{
+}
+
+bool CodeScanner::isAvailable()
+{
+#ifdef CAPTURE_HAVE_ZXING
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool CodeScanner::submit(const QImage &image, JobPool *pool)
+{
+    if (m_pending || image.isNull())
+        return false;
+
+    m_pending = true;
+
+    if (!pool)
+    {
+        QElapsedTimer clock;
+        clock.start();
+        const QJsonArray codes = decode(image);
+        complete(codes, clock.nsecsElapsed() / 1e6);
+        return true;
+    }
+
+    // A slow decode is counted as late, never dropped: the host is waiting
+    // for either CODE_RESULT or CODE_NONE.
+    QPointer<CodeScanner> self(this);
+    pool->submit([self, image]()
+    {
+        QElapsedTimer clock;
+        clock.start();
+        const QJsonArray codes = decode(image);
+        const double decodeMs = clock.nsecsElapsed() / 1e6;
+
+        if (!self)
+            return;
+        QMetaObject::invokeMethod(self, [self, codes, decodeMs]()
+        {
+            if (self)
+                self->complete(codes, decodeMs);
+        }, Qt::QueuedConnection);
+    }, JobPool::Clock::now() + kScanDeadline);
+    return true;
+}
+
+QJsonArray CodeScanner::decode(const QImage &image)
+{
+    QJsonArray codes;
+#ifdef CAPTURE_HAVE_ZXING
+    // ARGB32 is BGRX in memory on little-endian hosts; zxing reads it in
+    // place and builds its own luminance plane.
+    const QImage source = image.format() == QImage::Format_ARGB32 || image.format() == QImage::Format_RGB32
+        || image.format() == QImage::Format_ARGB32_Premultiplied
+        ? image
+        : image.convertToFormat(QImage::Format_RGB32);
+
+    const ZXing::ImageView view(source.constBits(), source.width(), source.height(),
+                                ZXing::ImageFormat::BGRX, int(source.bytesPerLine()));
+
+    ZXing::ReaderOptions options;
+    options.setFormats(ZXing::BarcodeFormat::Any);
+    options.setTryHarder(true);
+    options.setTryRotate(false); // screen content is upright
+    options.setMaxNumberOfSymbols(kMaxSymbols);
+
+    for (const auto &barcode : ZXing::ReadBarcodes(view, options))
+    {
+        if (!barcode.isValid())
+            continue;
+
+        QJsonArray position;
+        for (const auto &point : barcode.position())
+            position.append(QJsonArray{point.x, point.y});
+
+        QJsonObject code;
+        code["format"] = QString::fromStdString(ZXing::ToString(barcode.format()));
+        code["text"] = QString::fromStdString(barcode.text());
+        code["position"] = position;
+        codes.append(code);
+    }
+#else
+    Q_UNUSED(image);
+#endif
+    return codes;
+}
+
+void CodeScanner::complete(const QJsonArray &codes, double decodeMs)
+{
+    if (!m_pending)
+        return;
+    m_pending = false;
+
+    if (codes.isEmpty())
+    {
+        qDebug() << "[CodeScanner] No code found in" << decodeMs << "ms";
+        std::cout << "CODE_NONE" << std::endl;
+        std::cout.flush();
+        emit finished(false);
+        return;
+    }
+
+    QJsonObject reply;
+    reply["codes"] = codes;
+    reply["decode_ms"] = decodeMs;
+
+    std::cout << "CODE_RESULT" << std::endl;
+    std::cout << QJsonDocument(reply).toJson(QJsonDocument::Compact).toStdString() << std::endl;
+    std::cout.flush();
+
+    emit finished(true);
+}
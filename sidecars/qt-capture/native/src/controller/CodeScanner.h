@@ -0,0 +1,50 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef CODESCANNER_H
+#define CODESCANNER_H
+
+#include <QObject>
+#include <QImage>
+#include <QJsonArray>
+
+class JobPool;
+
+/**
+ * @brief Decodes QR codes and barcodes in the committed crop.
+ *
+ * Decoding runs as a job on the post-commit pool, in parallel with the
+ * PNG write, using the embedded zxing-cpp reader. Found codes are printed
+ * as a CODE_RESULT line followed by a JSON object
+ * ({"codes": [{"format", "text", "position"}], "decode_ms"}), otherwise
+ * CODE_NONE, so the host can skip OCR for pure code captures. Builds
+ * without zxing-cpp report CODE_NONE immediately.
+ */
+class CodeScanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CodeScanner(QObject *parent = nullptr);
+
+    static bool isAvailable();
+
+    bool submit(const QImage &image, JobPool *pool);
+    bool isPending() const { return m_pending; }
+
+signals:
+    void finished(bool found);
+
+private:
+    static QJsonArray decode(const QImage &image);
+    void complete(const QJsonArray &codes, double decodeMs);
+
+    bool m_pending = false;
+};
+
+#endif // CODESCANNER_H
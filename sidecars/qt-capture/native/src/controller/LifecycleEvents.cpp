@@ -0,0 +1,59 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "LifecycleEvents.h"
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+
+namespace {
+
+std::atomic<bool> g_enabled{false};
+QElapsedTimer g_clock;
+
+// Job threads may post too; a line must never interleave with another.
+std::mutex g_writeLock;
+
+} // namespace
+
+void LifecycleEvents::setEnabled(bool enabled)
+{
+    if (enabled && !g_clock.isValid())
+        g_clock.start();
+    g_enabled = enabled;
+}
+
+bool LifecycleEvents::isEnabled()
+{
+    return g_enabled;
+}
+
+void LifecycleEvents::post(const char *event, QJsonObject fields)
+{
+    if (!g_enabled)
+        return;
+
+    fields.insert("v", kVersion);
+    fields.insert("event", QString::fromLatin1(event));
+    fields.insert("t_ms", g_clock.nsecsElapsed() / 1000 / 1000.0);
+    const QByteArray json = QJsonDocument(fields).toJson(QJsonDocument::Compact);
+
+    std::lock_guard<std::mutex> lock(g_writeLock);
+    std::cout << "EVENT " << json.constData() << std::endl;
+    std::cout.flush();
+}
+
+QJsonArray LifecycleEvents::rect(const QRect &rect)
+{
+    return {rect.x(), rect.y(), rect.width(), rect.height()};
+}
+
+QJsonArray LifecycleEvents::rect(const QRectF &rect)
+{
+    return {rect.x(), rect.y(), rect.width(), rect.height()};
+}
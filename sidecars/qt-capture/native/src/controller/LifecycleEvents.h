@@ -0,0 +1,51 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef LIFECYCLEEVENTS_H
+#define LIFECYCLEEVENTS_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QRect>
+#include <QRectF>
+
+/**
+ * @brief Structured progress lines on the stdout protocol (--events).
+ *
+ * Each event is one line, "EVENT " followed by a compact JSON object
+ * carrying the protocol version, the event name and the milliseconds
+ * since startup, plus event-specific fields:
+ *
+ *     EVENT {"v":1,"event":"selection_committed","t_ms":812.4,...}
+ *
+ * Events, in order: frames_grabbed, overlay_visible (once per display),
+ * selection_started, selection_committed (logical and pixel geometry),
+ * preview_ready (with --preview), encode_done and result. They let the
+ * host warm OCR while the overlay is up and start on the geometry before
+ * the file exists. scroll_gap (with --scroll) reports the output row where
+ * content scrolled by faster than it could be stitched. The classic CAPTURE_SUCCESS/CAPTURE_FAIL lines are
+ * printed as before; nothing is printed unless enabled, so existing hosts
+ * see no change.
+ */
+namespace LifecycleEvents
+{
+constexpr int kVersion = 1;
+
+/// Turns event lines on and starts the t_ms clock.
+void setEnabled(bool enabled);
+bool isEnabled();
+
+/// Prints one event line; a no-op while disabled. Thread-safe.
+void post(const char *event, QJsonObject fields = QJsonObject());
+
+/// [x, y, width, height], the geometry encoding used by every event.
+QJsonArray rect(const QRect &rect);
+QJsonArray rect(const QRectF &rect);
+} // namespace LifecycleEvents
+
+#endif // LIFECYCLEEVENTS_H
@@ -0,0 +1,215 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "OcrClient.h"
+#include "LatencyProfile.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalSocket>
+#include <QtEndian>
+#include <QDebug>
+#include <iostream>
+
+namespace {
+
+constexpr int kConnectTimeoutMs = 250;
+constexpr int kReplyTimeoutMs = 20000;
+// Blocking socket waits are sliced so a cancel is noticed promptly.
+constexpr int kWaitSliceMs = 50;
+constexpr quint32 kMaxReplyBytes = 64u * 1024u * 1024u;
+
+void appendFrame(QByteArray &out, const QByteArray &payload)
+{
+    char prefix[4];
+    qToBigEndian<quint32>(quint32(payload.size()), prefix);
+    out.append(prefix, 4);
+    out.append(payload);
+}
+
+} // namespace
+
+OcrClient::OcrClient(const QString &serverPath, QObject *parent)
+    : QObject(parent)
+    , m_serverPath(serverPath)
+{
+    m_timeout.setSingleShot(true);
+    connect(&m_timeout, &QTimer::timeout, this, [this]() { fail("timed out"); });
+}
+
+OcrClient::~OcrClient()
+{
+    stopWorker();
+}
+
+bool OcrClient::submit(const QImage &image)
+{
+    if (m_pending || image.isNull())
+        return false;
+
+    stopWorker();
+    m_abort = false;
+    m_pending = true;
+    m_clock.start();
+    m_timeout.start(kReplyTimeoutMs);
+    m_worker = std::thread(&OcrClient::exchange, this, image, ++m_request);
+    return true;
+}
+
+void OcrClient::stopWorker()
+{
+    m_abort = true;
+    if (m_worker.joinable())
+        m_worker.join();
+}
+
+// Worker thread: the socket lives and dies here, results are queued back.
+void OcrClient::exchange(const QImage &image, quint64 request)
+{
+    LatencyProfile::resetCurrentThread();
+    auto failLater = [this, request](const QString &reason)
+    {
+        QMetaObject::invokeMethod(this, [this, request, reason]()
+                                  {
+                                      if (request == m_request)
+                                          fail(reason);
+                                  }, Qt::QueuedConnection);
+    };
+
+    QLocalSocket socket;
+    socket.connectToServer(m_serverPath, QIODevice::ReadWrite);
+    if (!socket.waitForConnected(kConnectTimeoutMs))
+    {
+        failLater(QString("worker not reachable at %1: %2").arg(m_serverPath, socket.errorString()));
+        return;
+    }
+
+    // ARGB32 is BGRA in memory on little-endian hosts; the worker drops the
+    // alpha lane and feeds the rows to the model without a colour conversion.
+    const QImage bgra = image.format() == QImage::Format_ARGB32 || image.format() == QImage::Format_RGB32
+        ? image
+        : image.convertToFormat(QImage::Format_ARGB32);
+    const qsizetype size = bgra.bytesPerLine() * bgra.height();
+
+    QJsonObject header;
+    header["format"] = QStringLiteral("bgra8888");
+    header["width"] = bgra.width();
+    header["height"] = bgra.height();
+    header["stride"] = int(bgra.bytesPerLine());
+    header["size"] = double(size);
+
+    QByteArray payload;
+    payload.reserve(size + 256);
+    appendFrame(payload, QJsonDocument(header).toJson(QJsonDocument::Compact));
+    payload.append(reinterpret_cast<const char *>(bgra.constBits()), size);
+
+    socket.write(payload);
+    while (socket.bytesToWrite() > 0)
+    {
+        if (m_abort)
+            return;
+        if (!socket.waitForBytesWritten(kWaitSliceMs) && socket.state() != QLocalSocket::ConnectedState)
+        {
+            failLater(socket.errorString());
+            return;
+        }
+    }
+    const double sendMs = double(m_clock.nsecsElapsed()) / 1e6;
+    qDebug() << "[OcrClient] Sent" << payload.size() << "bytes in" << sendMs << "ms";
+
+    QByteArray reply;
+    while (!m_abort)
+    {
+        // The worker closes right after replying; drain before checking state.
+        reply.append(socket.readAll());
+        if (reply.size() >= 4)
+        {
+            const quint32 length = qFromBigEndian<quint32>(reply.constData());
+            if (length > kMaxReplyBytes)
+            {
+                failLater("oversized reply");
+                return;
+            }
+            if (quint32(reply.size() - 4) >= length)
+            {
+                const QByteArray json = reply.mid(4, length);
+                QMetaObject::invokeMethod(this, [this, request, json, sendMs]()
+                                          {
+                                              if (request == m_request)
+                                                  complete(json, sendMs);
+                                          }, Qt::QueuedConnection);
+                return;
+            }
+        }
+        if (socket.state() != QLocalSocket::ConnectedState)
+        {
+            failLater(socket.errorString());
+            return;
+        }
+        socket.waitForReadyRead(kWaitSliceMs);
+    }
+}
+
+void OcrClient::complete(const QByteArray &json, double sendMs)
+{
+    if (!m_pending)
+        return;
+
+    QJsonParseError error;
+    QJsonObject reply = QJsonDocument::fromJson(json, &error).object();
+    if (error.error != QJsonParseError::NoError || reply.contains("error"))
+    {
+        fail(reply.value("error").toString(error.errorString()));
+        return;
+    }
+
+    QJsonObject timings = reply.value("timings").toObject();
+    timings["send_ms"] = sendMs;
+    timings["roundtrip_ms"] = double(m_clock.nsecsElapsed()) / 1e6;
+    reply["timings"] = timings;
+
+    m_pending = false;
+    m_timeout.stop();
+
+    std::cout << "OCR_RESULT" << std::endl;
+    std::cout << QJsonDocument(reply).toJson(QJsonDocument::Compact).toStdString() << std::endl;
+    std::cout.flush();
+
+    emit finished(true);
+}
+
+void OcrClient::fail(const QString &reason)
+{
+    if (!m_pending)
+        return;
+
+    qWarning() << "[OcrClient] OCR request failed:" << reason;
+
+    m_pending = false;
+    m_timeout.stop();
+    m_abort = true;
+
+    std::cout << "OCR_FAIL" << std::endl;
+    std::cout.flush();
+
+    emit finished(false);
+}
+
+void OcrClient::cancel(const QString &reason)
+{
+    if (!m_pending)
+        return;
+
+    qDebug() << "[OcrClient] OCR request cancelled:" << reason;
+
+    m_pending = false;
+    m_timeout.stop();
+    m_abort = true;
+
+    std::cout << "OCR_SKIPPED" << std::endl;
+    std::cout.flush();
+
+    emit finished(false);
+}
@@ -0,0 +1,64 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef OCRCLIENT_H
+#define OCRCLIENT_H
+
+#include <QObject>
+#include <QImage>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <atomic>
+#include <thread>
+
+/**
+ * @brief Hands committed crops to a warm OCR worker over a Unix socket.
+ * 
+ * The crop is streamed as raw BGRA rows the moment it exists. Connecting,
+ * writing the multi-megabyte request and waiting for the reply all happen
+ * on a dedicated thread, so the GUI thread goes straight on to encoding
+ * the PNG and tearing down the overlay while the worker runs OCR. The
+ * result is printed as an OCR_RESULT line followed by the worker's JSON
+ * reply (with the client send and round-trip times added), or OCR_FAIL on
+ * error/timeout, or OCR_SKIPPED when the request is cancelled.
+ * See sidecars/paddle-ocr/src/server.py for the wire format.
+ */
+class OcrClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit OcrClient(const QString &serverPath, QObject *parent = nullptr);
+    ~OcrClient() override;
+    
+    /// Starts a request in the background; false if one is already pending.
+    bool submit(const QImage &image);
+    bool isPending() const { return m_pending; }
+    void cancel(const QString &reason);
+    
+signals:
+    void finished(bool ok);
+
+private:
+    void exchange(const QImage &image, quint64 request);
+    void complete(const QByteArray &json, double sendMs);
+    void fail(const QString &reason);
+    void stopWorker();
+    
+    QString m_serverPath;
+    QTimer m_timeout;
+    QElapsedTimer m_clock;
+    bool m_pending = false;
+    quint64 m_request = 0; ///< Replies from an older request are ignored
+    
+    std::thread m_worker;
+    std::atomic<bool> m_abort{false};
+};
+
+#endif // OCRCLIENT_H
@@ -0,0 +1,75 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "QualityGovernor.h"
+#include <QQuickWindow>
+#include <QScreen>
+#include <QDebug>
+
+QualityGovernor::QualityGovernor(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void QualityGovernor::attach(QQuickWindow *window)
+{
+    m_window = window;
+    updateBudget();
+    connect(window, &QQuickWindow::screenChanged, this, &QualityGovernor::updateBudget);
+    connect(window, &QQuickWindow::beforeSynchronizing, window, [this]() { onFrameStarted(); }, Qt::DirectConnection);
+    connect(window, &QQuickWindow::frameSwapped, window, [this]() { onFrameSwapped(); }, Qt::DirectConnection);
+}
+
+void QualityGovernor::setFixedLevel(int level)
+{
+    m_fixed = true;
+    m_renderLevel = qBound(int(Minimal), level, int(Full));
+    applyLevel(m_renderLevel);
+}
+
+void QualityGovernor::updateBudget()
+{
+    const QScreen *screen = m_window ? m_window->screen() : nullptr;
+    const qreal refresh = screen && screen->refreshRate() > 1.0 ? screen->refreshRate() : 60.0;
+    m_budgetMs = 1000.0 / refresh;
+}
+
+void QualityGovernor::onFrameStarted()
+{
+    if (m_fixed)
+        return;
+
+    if (!m_clock.isValid())
+        m_clock.start();
+    m_frameStartNs = m_clock.nsecsElapsed();
+}
+
+void QualityGovernor::onFrameSwapped()
+{
+    if (m_fixed || m_frameStartNs < 0)
+        return;
+
+    const double ms = (m_clock.nsecsElapsed() - m_frameStartNs) / 1e6;
+    m_frameStartNs = -1;
+
+    const int next = m_policy.addFrame(ms, m_budgetMs);
+    if (next != m_renderLevel)
+    {
+        m_renderLevel = next;
+        QMetaObject::invokeMethod(this, [this, next]() { applyLevel(next); }, Qt::QueuedConnection);
+    }
+}
+
+void QualityGovernor::applyLevel(int level)
+{
+    if (level == m_level)
+        return;
+
+    qDebug() << "[QualityGovernor] Effect quality" << m_level << "->" << level
+             << "(budget" << m_budgetMs.load() << "ms)";
+    m_level = level;
+    emit levelChanged();
+}
@@ -0,0 +1,76 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef QUALITYGOVERNOR_H
+#define QUALITYGOVERNOR_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <atomic>
+
+#include "QualityPolicy.h"
+
+class QQuickWindow;
+
+/**
+ * @brief Steps overlay effect quality down (and back up) to hold the
+ * display's refresh budget.
+ *
+ * Each frame is timed on the render thread from beforeSynchronizing to
+ * frameSwapped. The span covers the swap, where a GPU still busy with the
+ * glow passes blocks the render thread, and leaves out the idle time
+ * between frames of an overlay that only redraws on input. QualityPolicy
+ * turns those times into a level. QML binds glow radius, sample counts and
+ * layers to @c level, so only decoration changes; selection geometry is
+ * drawn the same at every level.
+ */
+class QualityGovernor : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int level READ level NOTIFY levelChanged)
+
+public:
+    enum Level
+    {
+        Minimal = 0, ///< No glow passes or masking layer
+        Reduced = 1, ///< Fewer samples, smaller radii
+        Full = 2     ///< The designed look
+    };
+    Q_ENUM(Level)
+
+    explicit QualityGovernor(QObject *parent = nullptr);
+
+    void attach(QQuickWindow *window);
+
+    /// Pins the level and stops adapting (for --render-quality).
+    void setFixedLevel(int level);
+
+    int level() const { return m_level; }
+
+signals:
+    void levelChanged();
+
+private:
+    void onFrameStarted();
+    void onFrameSwapped();
+    void updateBudget();
+    void applyLevel(int level);
+
+    QQuickWindow *m_window = nullptr;
+    int m_level = Full;
+    bool m_fixed = false;
+
+    // Render thread state.
+    QElapsedTimer m_clock;
+    qint64 m_frameStartNs = -1;
+    QualityPolicy m_policy{Full, Minimal, Full};
+    int m_renderLevel = Full;
+    std::atomic<double> m_budgetMs{1000.0 / 60.0};
+};
+
+#endif // QUALITYGOVERNOR_H
@@ -0,0 +1,64 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "QualityPolicy.h"
+#include <algorithm>
+
+namespace {
+
+constexpr int kWindowFrames = 20;
+constexpr int kMissedFramesToDrop = 5;
+
+// Frame times include the wait for vblank, so a frame that kept up takes
+// about one budget and one that missed takes about two. The margins absorb
+// timer and scheduling jitter.
+constexpr double kMissedShare = 1.5;
+constexpr double kCleanShare = 1.1;
+
+constexpr int kCleanWindowsToRaise = 6;
+constexpr int kMaxWindowsToRaise = 96;
+
+} // namespace
+
+QualityPolicy::QualityPolicy(int level, int minLevel, int maxLevel)
+    : m_level(level)
+    , m_minLevel(minLevel)
+    , m_maxLevel(maxLevel)
+    , m_windowsToRaise(kCleanWindowsToRaise)
+{
+}
+
+int QualityPolicy::addFrame(double ms, double budgetMs)
+{
+    if (ms > budgetMs * kMissedShare)
+        ++m_missedFrames;
+    if (ms > budgetMs * kCleanShare)
+        m_windowClean = false;
+
+    if (++m_frames < kWindowFrames)
+        return m_level;
+
+    if (m_missedFrames >= kMissedFramesToDrop && m_level > m_minLevel)
+    {
+        --m_level;
+        m_cleanWindows = 0;
+        m_windowsToRaise = std::min(m_windowsToRaise * 2, kMaxWindowsToRaise);
+    }
+    else if (!m_windowClean)
+    {
+        m_cleanWindows = 0;
+    }
+    else if (++m_cleanWindows >= m_windowsToRaise && m_level < m_maxLevel)
+    {
+        ++m_level;
+        m_cleanWindows = 0;
+    }
+
+    m_frames = 0;
+    m_missedFrames = 0;
+    m_windowClean = true;
+    return m_level;
+}
@@ -0,0 +1,44 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef QUALITYPOLICY_H
+#define QUALITYPOLICY_H
+
+/**
+ * @brief The stepping rules behind QualityGovernor, free of Qt.
+ *
+ * Fed one frame time at a time against the refresh budget, it decides when
+ * the effect level drops or climbs. Frames are judged in windows so a
+ * single hitch never changes the look: a window with several frames that
+ * missed the budget drops one level, and a long run of windows without a
+ * miss raises it again. Every drop doubles the run needed to come back,
+ * so a level the GPU cannot hold is not retried every few seconds.
+ */
+class QualityPolicy
+{
+public:
+    explicit QualityPolicy(int level, int minLevel, int maxLevel);
+
+    /// Records a frame of @p ms against @p budgetMs; returns the level to use.
+    int addFrame(double ms, double budgetMs);
+
+    int level() const { return m_level; }
+
+private:
+    int m_level;
+    int m_minLevel;
+    int m_maxLevel;
+
+    int m_frames = 0;
+    int m_missedFrames = 0;
+    bool m_windowClean = true;
+    int m_cleanWindows = 0;
+    int m_windowsToRaise;
+};
+
+#endif // QUALITYPOLICY_H
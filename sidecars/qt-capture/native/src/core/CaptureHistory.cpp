@@ -0,0 +1,559 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "CaptureHistory.h"
+#include "FramePool.h"
+#include "LatencyProfile.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLockFile>
+#include <QPainter>
+#include <QSaveFile>
+#include <QScreen>
+#include <QStandardPaths>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+
+#ifdef CAPTURE_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace
+{
+constexpr int kCompressionLevel = 1;
+constexpr int kThumbnailEdge = 320;
+
+QString indexPath()
+{
+    return QDir(CaptureHistory::directory()).filePath("index.json");
+}
+
+QJsonArray readIndex()
+{
+    QFile file(indexPath());
+    if (!file.open(QIODevice::ReadOnly))
+        return QJsonArray();
+    return QJsonDocument::fromJson(file.readAll()).array();
+}
+
+#ifdef CAPTURE_HAVE_ZSTD
+bool writeIndex(const QJsonArray &entries)
+{
+    QSaveFile file(indexPath());
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(QJsonDocument(entries).toJson(QJsonDocument::Indented));
+    return file.commit();
+}
+
+/// Whole virtual desktop scaled to fit kThumbnailEdge, for pickers.
+QImage thumbnail(const std::vector<CapturedFrame> &frames)
+{
+    QRect desktop;
+    for (const CapturedFrame &frame : frames)
+        desktop = desktop.united(frame.geometry);
+    if (desktop.isEmpty())
+        return QImage();
+
+    const qreal scale = qreal(kThumbnailEdge) / qMax(desktop.width(), desktop.height());
+    QImage thumb((QSizeF(desktop.size()) * scale).toSize().expandedTo(QSize(1, 1)), QImage::Format_RGB32);
+    thumb.fill(Qt::black);
+
+    QPainter painter(&thumb);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    for (const CapturedFrame &frame : frames)
+    {
+        const QRectF target(QPointF(frame.geometry.topLeft() - desktop.topLeft()) * scale,
+                            QSizeF(frame.geometry.size()) * scale);
+        QImage source = frame.image;
+        source.setDevicePixelRatio(1.0);
+        painter.drawImage(target, source);
+    }
+    return thumb;
+}
+
+struct CompressedFrame
+{
+    SessionFile::SessionFrameRecord record{};
+    std::vector<QByteArray> bands;
+};
+
+bool compressFrame(ZSTD_CCtx *cctx, const CapturedFrame &frame, CompressedFrame &out)
+{
+    const QImage image = SessionFile::isStoredFormat(uint32_t(frame.image.format()))
+        ? frame.image
+        : frame.image.convertToFormat(QImage::Format_RGB32);
+    const qsizetype stride = qsizetype(image.width()) * 4;
+
+    SessionFile::SessionFrameRecord &rec = out.record;
+    rec.x = frame.geometry.x();
+    rec.y = frame.geometry.y();
+    rec.width = frame.geometry.width();
+    rec.height = frame.geometry.height();
+    rec.devicePixelRatio = frame.devicePixelRatio;
+    rec.index = frame.index;
+    rec.pixelFormat = uint32_t(image.format());
+    rec.pixelWidth = uint32_t(image.width());
+    rec.pixelHeight = uint32_t(image.height());
+    rec.stride = uint32_t(stride);
+    rec.planeSize = uint64_t(stride) * uint64_t(image.height());
+
+    const QByteArray name = frame.name.toUtf8().left(SessionFile::kNameLength - 1);
+    memcpy(rec.name, name.constData(), size_t(name.size()));
+
+    QByteArray scratch;
+    for (int row = 0; row < image.height(); row += int(CaptureHistory::kBandRows))
+    {
+        const int rows = qMin(int(CaptureHistory::kBandRows), image.height() - row);
+        const size_t rawSize = size_t(stride) * size_t(rows);
+
+        const char *raw = reinterpret_cast<const char *>(image.constScanLine(row));
+        if (image.bytesPerLine() != stride)
+        {
+            scratch.resize(qsizetype(rawSize));
+            for (int y = 0; y < rows; ++y)
+                memcpy(scratch.data() + y * stride, image.constScanLine(row + y), size_t(stride));
+            raw = scratch.constData();
+        }
+
+        QByteArray band;
+        band.resize(qsizetype(ZSTD_compressBound(rawSize)));
+        const size_t written = ZSTD_compressCCtx(cctx, band.data(), size_t(band.size()),
+                                                 raw, rawSize, kCompressionLevel);
+        if (ZSTD_isError(written))
+        {
+            qWarning() << "[CaptureHistory] Compression failed:" << ZSTD_getErrorName(written);
+            return false;
+        }
+        band.resize(qsizetype(written));
+        out.bands.push_back(std::move(band));
+    }
+    return true;
+}
+
+bool writeSession(const QString &path, const std::vector<CapturedFrame> &frames, qint64 createdMs, qint64 *bytes)
+{
+    std::vector<CompressedFrame> compressed;
+    ZSTD_CCtx *cctx = ZSTD_createCCtx();
+    bool ok = cctx != nullptr;
+    for (const CapturedFrame &frame : frames)
+    {
+        // Mirrors re-open through the frame they clone.
+        if (!ok || frame.mirrorOf >= 0 || frame.image.isNull())
+            continue;
+        compressed.emplace_back();
+        ok = compressFrame(cctx, frame, compressed.back());
+    }
+    ZSTD_freeCCtx(cctx);
+    if (!ok || compressed.empty())
+        return false;
+
+    CaptureHistory::HistoryHeader header{};
+    memcpy(header.magic, CaptureHistory::kMagic, sizeof(CaptureHistory::kMagic));
+    header.version = CaptureHistory::kVersion;
+    header.frameCount = uint32_t(compressed.size());
+    header.bandRows = CaptureHistory::kBandRows;
+    header.recordSize = sizeof(SessionFile::SessionFrameRecord);
+    header.createdMs = createdMs;
+
+    // Lay out band tables and bands after the records.
+    uint64_t offset = sizeof(header) + compressed.size() * sizeof(SessionFile::SessionFrameRecord);
+    std::vector<std::vector<uint64_t>> tables(compressed.size());
+    for (size_t i = 0; i < compressed.size(); ++i)
+    {
+        compressed[i].record.planeOffset = offset;
+        offset += (compressed[i].bands.size() + 1) * sizeof(uint64_t);
+        for (const QByteArray &band : compressed[i].bands)
+        {
+            tables[i].push_back(offset);
+            offset += uint64_t(band.size());
+        }
+        tables[i].push_back(offset);
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (const CompressedFrame &frame : compressed)
+        file.write(reinterpret_cast<const char *>(&frame.record), sizeof(frame.record));
+    for (size_t i = 0; i < compressed.size(); ++i)
+    {
+        file.write(reinterpret_cast<const char *>(tables[i].data()), qint64(tables[i].size() * sizeof(uint64_t)));
+        for (const QByteArray &band : compressed[i].bands)
+            file.write(band);
+    }
+
+    if (!file.commit())
+        return false;
+    *bytes = qint64(offset);
+    return true;
+}
+
+/// Adds @p entry at the front and drops sessions past the count/size caps.
+void updateIndex(const QJsonObject &entry)
+{
+    // The host does not wait for this process, so the next capture's
+    // writer may already be running.
+    QLockFile lock(QDir(CaptureHistory::directory()).filePath("index.lock"));
+    if (!lock.lock())
+    {
+        qWarning() << "[CaptureHistory] Cannot lock" << indexPath();
+        return;
+    }
+
+    QJsonArray entries = readIndex();
+    entries.prepend(entry);
+
+    const QDir dir(CaptureHistory::directory());
+    QJsonArray kept;
+    qint64 total = 0;
+    for (const QJsonValue &value : entries)
+    {
+        const QJsonObject session = value.toObject();
+        total += qint64(session.value("bytes").toDouble());
+        const bool fits = kept.isEmpty()
+            || (kept.size() < CaptureHistory::kMaxSessions && uint64_t(total) <= CaptureHistory::kMaxBytes);
+        if (fits)
+        {
+            kept.append(session);
+            continue;
+        }
+        QFile::remove(dir.filePath(session.value("file").toString()));
+        QFile::remove(dir.filePath(session.value("thumbnail").toString()));
+    }
+
+    if (!writeIndex(kept))
+        qWarning() << "[CaptureHistory] Failed to update" << indexPath();
+}
+#endif
+
+void storeSession(const std::vector<CapturedFrame> &frames)
+{
+#ifdef CAPTURE_HAVE_ZSTD
+    QElapsedTimer clock;
+    clock.start();
+
+    const QDir dir(CaptureHistory::directory());
+    if (!dir.mkpath("."))
+    {
+        qWarning() << "[CaptureHistory] Cannot create" << dir.path();
+        return;
+    }
+
+    const qint64 createdMs = QDateTime::currentMSecsSinceEpoch();
+    const QString id = QString::number(createdMs);
+    const QString file = QString("session-%1.qcah").arg(id);
+    const QString thumb = QString("session-%1.png").arg(id);
+
+    qint64 bytes = 0;
+    if (!writeSession(dir.filePath(file), frames, createdMs, &bytes))
+    {
+        qWarning() << "[CaptureHistory] Failed to store session";
+        QFile::remove(dir.filePath(file));
+        return;
+    }
+    thumbnail(frames).save(dir.filePath(thumb), "PNG");
+
+    QJsonArray screens;
+    for (const CapturedFrame &frame : frames)
+    {
+        if (frame.mirrorOf >= 0)
+            continue;
+        QJsonObject screen;
+        screen["name"] = frame.name;
+        screen["x"] = frame.geometry.x();
+        screen["y"] = frame.geometry.y();
+        screen["width"] = frame.geometry.width();
+        screen["height"] = frame.geometry.height();
+        screen["dpr"] = frame.devicePixelRatio;
+        screens.append(screen);
+    }
+
+    QJsonObject entry;
+    entry["id"] = id;
+    entry["file"] = file;
+    entry["thumbnail"] = thumb;
+    entry["created"] = QDateTime::fromMSecsSinceEpoch(createdMs).toString(Qt::ISODateWithMs);
+    entry["bytes"] = double(bytes);
+    entry["screens"] = screens;
+    updateIndex(entry);
+
+    qDebug() << "[CaptureHistory] Stored session" << id << "(" << bytes << "bytes) in"
+             << clock.nsecsElapsed() / 1e6 << "ms";
+#else
+    Q_UNUSED(frames);
+#endif
+}
+} // namespace
+
+bool CaptureHistory::isAvailable()
+{
+#ifdef CAPTURE_HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+}
+
+QString CaptureHistory::directory()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("history");
+}
+
+QString CaptureHistory::sessionPath(int n)
+{
+    const QJsonArray entries = readIndex();
+    if (n < 1 || n > entries.size())
+        return QString();
+    return QDir(directory()).filePath(entries.at(n - 1).toObject().value("file").toString());
+}
+
+HistoryWriter::~HistoryWriter()
+{
+    wait();
+}
+
+void HistoryWriter::start(std::vector<CapturedFrame> frames)
+{
+    if (m_thread.joinable() || !CaptureHistory::isAvailable())
+        return;
+    m_thread = std::thread([frames = std::move(frames)]()
+                           {
+                               LatencyProfile::resetCurrentThread();
+                               storeSession(frames);
+                           });
+}
+
+void HistoryWriter::wait()
+{
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+class HistoryGrabber : public ScreenGrabber
+{
+public:
+    HistoryGrabber(const QString &path, QObject *parent) : ScreenGrabber(parent), m_file(path) {}
+
+    std::vector<CapturedFrame> captureAll() override
+    {
+        std::vector<CapturedFrame> frames;
+#ifdef CAPTURE_HAVE_ZSTD
+        QElapsedTimer clock;
+        clock.start();
+
+        if (!m_file.isOpen() && !m_file.open(QIODevice::ReadOnly))
+        {
+            qCritical() << "[CaptureHistory] Cannot open" << m_file.fileName();
+            return frames;
+        }
+
+        const qint64 size = m_file.size();
+        const uchar *base = m_file.map(0, size);
+        if (!base || size < qint64(sizeof(CaptureHistory::HistoryHeader)))
+        {
+            qCritical() << "[CaptureHistory] Cannot map" << m_file.fileName();
+            return frames;
+        }
+
+        const auto *header = reinterpret_cast<const CaptureHistory::HistoryHeader *>(base);
+        const uint64_t recordsEnd = sizeof(*header)
+            + uint64_t(header->frameCount) * sizeof(SessionFile::SessionFrameRecord);
+
+        if (memcmp(header->magic, CaptureHistory::kMagic, sizeof(CaptureHistory::kMagic)) != 0
+            || header->version != CaptureHistory::kVersion
+            || header->recordSize != sizeof(SessionFile::SessionFrameRecord)
+            || header->bandRows == 0
+            || recordsEnd > uint64_t(size))
+        {
+            qCritical() << "[CaptureHistory] Not a supported history session:" << m_file.fileName();
+            return frames;
+        }
+
+        const auto *records = reinterpret_cast<const SessionFile::SessionFrameRecord *>(base + sizeof(*header));
+        const std::vector<uint32_t> wanted = displayedFrames(records, header->frameCount);
+
+        struct Band
+        {
+            size_t frame;
+            uchar *target;
+            qsizetype targetStride;
+            uint32_t rows;
+            const uchar *data;
+            size_t length;
+        };
+        std::vector<Band> bands;
+
+        for (uint32_t i : wanted)
+        {
+            const SessionFile::SessionFrameRecord &rec = records[i];
+            const uint64_t bandCount = (uint64_t(rec.pixelHeight) + header->bandRows - 1) / header->bandRows;
+            const uint64_t tableBytes = (bandCount + 1) * sizeof(uint64_t);
+            // Same record checks as a session file; no sum or product can
+            // wrap, the 32-bit factors multiply in 64 bits.
+            if (!SessionFile::isStoredFormat(rec.pixelFormat)
+                || rec.pixelWidth == 0 || rec.pixelHeight == 0
+                || rec.pixelWidth > uint32_t(std::numeric_limits<int>::max())
+                || rec.pixelHeight > uint32_t(std::numeric_limits<int>::max())
+                || uint64_t(rec.stride) != uint64_t(rec.pixelWidth) * 4
+                || uint64_t(rec.stride) * rec.pixelHeight > rec.planeSize
+                || rec.planeOffset > uint64_t(size) || tableBytes > uint64_t(size) - rec.planeOffset)
+            {
+                qWarning() << "[CaptureHistory] Skipping corrupt frame record" << i;
+                continue;
+            }
+
+            std::vector<uint64_t> table(bandCount + 1);
+            memcpy(table.data(), base + rec.planeOffset, table.size() * sizeof(uint64_t));
+            if (table.back() > uint64_t(size) || !std::is_sorted(table.begin(), table.end()))
+            {
+                qWarning() << "[CaptureHistory] Skipping truncated frame" << i;
+                continue;
+            }
+
+            CapturedFrame frame;
+            frame.image = FramePool::instance().acquire(QSize(int(rec.pixelWidth), int(rec.pixelHeight)),
+                                                        QImage::Format(rec.pixelFormat));
+            if (frame.image.isNull())
+            {
+                qWarning() << "[CaptureHistory] Cannot allocate frame" << i;
+                continue;
+            }
+            frame.geometry = QRect(rec.x, rec.y, rec.width, rec.height);
+            frame.devicePixelRatio = rec.devicePixelRatio;
+            frame.index = rec.index;
+            frame.name = QString::fromUtf8(rec.name, int(strnlen(rec.name, SessionFile::kNameLength)));
+            // Detach once here; the decode threads only write through bits.
+            uchar *bits = frame.image.bits();
+            const qsizetype bytesPerLine = frame.image.bytesPerLine();
+            frames.push_back(frame);
+
+            for (uint64_t b = 0; b < bandCount; ++b)
+            {
+                const uint32_t row = uint32_t(b * header->bandRows);
+                bands.push_back({frames.size() - 1, bits + row * bytesPerLine, bytesPerLine,
+                                 qMin(header->bandRows, rec.pixelHeight - row),
+                                 base + table[b], size_t(table[b + 1] - table[b])});
+            }
+        }
+
+        // Bands are independent zstd frames: decode them across cores.
+        std::vector<std::atomic<bool>> failed(frames.size());
+        for (std::atomic<bool> &flag : failed)
+            flag = false;
+
+        std::atomic<size_t> next{0};
+        auto decodeBands = [&]()
+        {
+            for (size_t i = next++; i < bands.size(); i = next++)
+            {
+                const Band &band = bands[i];
+                const size_t stride = size_t(frames[band.frame].image.width()) * 4;
+                const size_t rawSize = stride * band.rows;
+
+                QByteArray scratch;
+                uchar *target = band.target;
+                if (size_t(band.targetStride) != stride)
+                {
+                    scratch.resize(qsizetype(rawSize));
+                    target = reinterpret_cast<uchar *>(scratch.data());
+                }
+
+                const size_t written = ZSTD_decompress(target, rawSize, band.data, band.length);
+                if (ZSTD_isError(written) || written != rawSize)
+                {
+                    failed[band.frame] = true;
+                    continue;
+                }
+                if (!scratch.isEmpty())
+                {
+                    for (uint32_t y = 0; y < band.rows; ++y)
+                        memcpy(band.target + y * band.targetStride, scratch.constData() + y * stride, stride);
+                }
+            }
+        };
+
+        const size_t threadCount = qBound<size_t>(1, std::thread::hardware_concurrency(), bands.size());
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < threadCount; ++t)
+            threads.emplace_back(decodeBands);
+        decodeBands();
+        for (std::thread &thread : threads)
+            thread.join();
+
+        std::vector<CapturedFrame> decoded;
+        for (size_t i = 0; i < frames.size(); ++i)
+        {
+            if (failed[i])
+            {
+                qWarning() << "[CaptureHistory] Failed to decompress frame" << frames[i].name;
+                continue;
+            }
+            frames[i].image.setDevicePixelRatio(frames[i].devicePixelRatio);
+            decoded.push_back(frames[i]);
+        }
+
+        qDebug() << "[CaptureHistory] Re-opened" << decoded.size() << "of" << header->frameCount
+                 << "frames in" << clock.nsecsElapsed() / 1e6 << "ms";
+
+        ScreenGrabber::sortLeftToRight(decoded);
+        return decoded;
+#else
+        qCritical() << "[CaptureHistory] Built without zstd; cannot re-open" << m_file.fileName();
+        return frames;
+#endif
+    }
+
+private:
+    /// Frames whose display is connected now; all of them if none is.
+    static std::vector<uint32_t> displayedFrames(const SessionFile::SessionFrameRecord *records, uint32_t count)
+    {
+        std::vector<uint32_t> wanted;
+        const QList<QScreen *> screens = QGuiApplication::screens();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const QString name = QString::fromUtf8(records[i].name, int(strnlen(records[i].name, SessionFile::kNameLength)));
+            const QRect geometry(records[i].x, records[i].y, records[i].width, records[i].height);
+            for (QScreen *screen : screens)
+            {
+                if (screen->name() == name || screen->geometry() == geometry)
+                {
+                    wanted.push_back(i);
+                    break;
+                }
+            }
+        }
+
+        if (wanted.empty())
+        {
+            for (uint32_t i = 0; i < count; ++i)
+                wanted.push_back(i);
+        }
+        else if (wanted.size() < count)
+        {
+            qDebug() << "[CaptureHistory] Skipping" << count - wanted.size() << "frames of disconnected displays";
+        }
+        return wanted;
+    }
+
+    QFile m_file;
+};
+
+ScreenGrabber *createHistoryEngine(const QString &path, QObject *parent)
+{
+    return new HistoryGrabber(path, parent);
+}
@@ -0,0 +1,94 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef CAPTUREHISTORY_H
+#define CAPTUREHISTORY_H
+
+#include <QString>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "ScreenGrabber.h"
+#include "SessionFile.h"
+
+/**
+ * @brief Bounded on-disk ring of recent capture sessions.
+ *
+ * Each session is one file holding the full-screen frames as independently
+ * zstd-compressed bands of rows:
+ *
+ *     HistoryHeader
+ *     SessionFile::SessionFrameRecord[frameCount]
+ *     per frame: uint64_t bandOffsets[bandCount + 1], then the bands
+ *
+ * A frame record's planeOffset points at its band table and planeSize is
+ * the decompressed plane size. index.json next to the sessions lists them
+ * newest first, with a small PNG thumbnail each, and is what the ring is
+ * pruned against.
+ */
+namespace CaptureHistory
+{
+constexpr char kMagic[8] = {'Q', 'C', 'A', 'P', 'H', 'I', 'S', 'T'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kBandRows = 128;
+constexpr int kMaxSessions = 10;
+constexpr uint64_t kMaxBytes = 512ull * 1024 * 1024;
+
+struct HistoryHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t frameCount;
+    uint32_t bandRows;
+    uint32_t recordSize;
+    int64_t createdMs;
+};
+
+static_assert(sizeof(HistoryHeader) == 32, "HistoryHeader layout changed");
+
+/// False when built without libzstd; the history is then never written.
+bool isAvailable();
+
+QString directory();
+
+/// File of the @p n-th most recent session (1 = newest), or empty.
+QString sessionPath(int n);
+} // namespace CaptureHistory
+
+/**
+ * @brief Compresses a session into the history on a background thread.
+ *
+ * Started once the result has been emitted so it never competes with the
+ * crop/encode path; the destructor waits for it.
+ */
+class HistoryWriter
+{
+public:
+    HistoryWriter() = default;
+    ~HistoryWriter();
+
+    HistoryWriter(const HistoryWriter &) = delete;
+    HistoryWriter &operator=(const HistoryWriter &) = delete;
+
+    void start(std::vector<CapturedFrame> frames);
+    bool isStarted() const { return m_thread.joinable(); }
+    void wait();
+
+private:
+    std::thread m_thread;
+};
+
+/**
+ * Grabber that re-opens a stored session. Only frames of displays that are
+ * connected now are decompressed, band by band across threads, straight
+ * into pooled frame buffers.
+ */
+ScreenGrabber *createHistoryEngine(const QString &path, QObject *parent);
+
+#endif // CAPTUREHISTORY_H
@@ -0,0 +1,224 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "CaptureTuning.h"
+#include "FrameOps.h"
+#include "JobPool.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QSettings>
+#include <QDebug>
+#include <algorithm>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+constexpr char kGroup[] = "tuning";
+constexpr int kMaxThreads = 8;
+constexpr double kThreadTolerance = 1.05;
+
+// Large enough to behave like a real selection, small enough that a full
+// --calibrate stays within a few seconds.
+const QSize kSampleSize(1920, 1080);
+constexpr int kPreviewEdge = 512;
+
+double median(std::vector<double> values)
+{
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+QString describeScreens()
+{
+    QList<QScreen *> screens = QGuiApplication::screens();
+    std::sort(screens.begin(), screens.end(), [](QScreen *a, QScreen *b)
+              { return a->name() < b->name(); });
+
+    QStringList parts;
+    for (QScreen *screen : screens)
+    {
+        const QRect g = screen->geometry();
+        parts << QString("%1@%2,%3,%4x%5*%6").arg(screen->name()).arg(g.x()).arg(g.y())
+                     .arg(g.width()).arg(g.height()).arg(screen->devicePixelRatio());
+    }
+    return parts.join(' ');
+}
+
+// One post-commit job mix as CaptureController submits it with --preview:
+// the full encode and the downscaled preview. Returns the makespan.
+double timeJobMix(JobPool &pool, const QImage &sample)
+{
+    std::mutex lock;
+    std::condition_variable done;
+    int remaining = 2;
+    auto finish = [&]()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (--remaining == 0)
+            done.notify_one();
+    };
+
+    QElapsedTimer clock;
+    clock.start();
+    pool.submit([&]()
+                {
+                    FrameOps::encode(sample, "PNG");
+                    finish();
+                });
+    pool.submit([&]()
+                {
+                    FrameOps::encode(sample.scaled(kPreviewEdge, kPreviewEdge, Qt::KeepAspectRatio,
+                                                   Qt::SmoothTransformation),
+                                     "PNG", 80);
+                    finish();
+                });
+
+    std::unique_lock<std::mutex> wait(lock);
+    done.wait(wait, [&]() { return remaining == 0; });
+    return clock.nsecsElapsed() / 1e6;
+}
+
+} // namespace
+
+QString CaptureTuning::configurationKey()
+{
+    const QString description = QStringList{
+        qEnvironmentVariable("XDG_SESSION_TYPE"),
+        qEnvironmentVariable("XDG_CURRENT_DESKTOP"),
+        QGuiApplication::platformName(),
+        describeScreens(),
+    }.join('|');
+    return QString::fromLatin1(
+        QCryptographicHash::hash(description.toUtf8(), QCryptographicHash::Sha1).toHex().left(16));
+}
+
+CaptureTuning::Tuning CaptureTuning::load(const QString &key)
+{
+    QSettings settings;
+    settings.beginGroup(kGroup);
+    settings.beginGroup(key);
+
+    Tuning tuning;
+    tuning.calibrated = settings.contains("backend");
+    tuning.backend = settings.value("backend").toString();
+    tuning.encoderThreads = settings.value("encoderThreads", 0).toInt();
+    tuning.grabMs = settings.value("grabMs", -1.0).toDouble();
+    return tuning;
+}
+
+void CaptureTuning::store(const QString &key, const Tuning &tuning)
+{
+    QSettings settings;
+    settings.beginGroup(kGroup);
+    settings.beginGroup(key);
+
+    settings.setValue("backend", tuning.backend);
+    settings.setValue("encoderThreads", tuning.encoderThreads);
+    settings.setValue("grabMs", tuning.grabMs);
+    settings.setValue("screens", describeScreens());
+    settings.setValue("calibratedAt", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+}
+
+QString CaptureTuning::pickBackend(ScreenGrabber *grabber, int runs, double *grabMs,
+                                   std::vector<CapturedFrame> *frames)
+{
+    QString best;
+    double bestMs = std::numeric_limits<double>::max();
+    int grabs = 0;
+    QElapsedTimer total;
+    total.start();
+
+    for (const QString &backend : grabber->backends())
+    {
+        // Untimed: the first grab pays for SHM attach, first pool buffers
+        // and page faults, which would otherwise count against whichever
+        // backend happens to run first.
+        ++grabs;
+        if (grabber->captureWith(backend).empty())
+        {
+            qInfo() << "[CaptureTuning]" << backend << "produced no frames";
+            continue;
+        }
+
+        std::vector<double> times;
+        std::vector<CapturedFrame> last;
+        for (int i = 0; i < runs; ++i)
+        {
+            QElapsedTimer clock;
+            clock.start();
+            std::vector<CapturedFrame> grabbed = grabber->captureWith(backend);
+            const double ms = clock.nsecsElapsed() / 1e6;
+            ++grabs;
+
+            if (grabbed.empty())
+            {
+                times.clear();
+                break;
+            }
+            times.push_back(ms);
+            last = std::move(grabbed);
+        }
+
+        if (times.empty())
+        {
+            qInfo() << "[CaptureTuning]" << backend << "produced no frames";
+            continue;
+        }
+
+        const double ms = median(times);
+        qInfo() << "[CaptureTuning]" << backend << "median" << ms << "ms over" << times.size() << "grabs";
+        if (ms < bestMs)
+        {
+            best = backend;
+            bestMs = ms;
+            if (frames)
+                *frames = std::move(last);
+        }
+    }
+
+    qInfo() << "[CaptureTuning]" << grabs << "grabs in" << total.nsecsElapsed() / 1e6 << "ms";
+    if (grabMs)
+        *grabMs = best.isEmpty() ? -1.0 : bestMs;
+    return best;
+}
+
+int CaptureTuning::pickEncoderThreads(const QImage &sample, int runs)
+{
+    if (sample.isNull())
+        return 0;
+
+    QRect area(QPoint(0, 0), sample.size().boundedTo(kSampleSize));
+    area.moveCenter(sample.rect().center());
+    const QImage crop = sample.copy(area);
+
+    const int maxThreads = std::clamp(int(std::thread::hardware_concurrency()), 1, kMaxThreads);
+    std::vector<double> makespans;
+    for (int threads = 1; threads <= maxThreads; ++threads)
+    {
+        JobPool pool(threads);
+        timeJobMix(pool, crop); // warm-up: thread start, first allocations
+
+        std::vector<double> times;
+        for (int i = 0; i < runs; ++i)
+            times.push_back(timeJobMix(pool, crop));
+        makespans.push_back(median(times));
+        qInfo() << "[CaptureTuning]" << threads << "encoder threads:" << makespans.back() << "ms";
+    }
+
+    const double fastest = *std::min_element(makespans.begin(), makespans.end());
+    for (size_t i = 0; i < makespans.size(); ++i)
+    {
+        if (makespans[i] <= fastest * kThreadTolerance)
+            return int(i) + 1;
+    }
+    return 0;
+}
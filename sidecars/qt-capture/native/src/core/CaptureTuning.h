@@ -0,0 +1,67 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef CAPTURETUNING_H
+#define CAPTURETUNING_H
+
+#include <QImage>
+#include <QString>
+#include <vector>
+
+#include "ScreenGrabber.h"
+
+/**
+ * @brief Measured grab backend and job pool size, cached per display setup.
+ *
+ * Which grab path is fastest depends on the driver, compositor and number
+ * of monitors, so it is timed on the machine instead of guessed: every
+ * backend the grabber can run without user interaction grabs the screens
+ * a few times and the lowest median wins. --calibrate also times the
+ * post-commit job mix (full encode and preview) for each pool size. The
+ * results are stored in QSettings under a key derived from the session
+ * type, desktop and screen layout, so plugging in another monitor or
+ * switching sessions calibrates afresh.
+ */
+namespace CaptureTuning
+{
+/// Timed grabs per backend when a new configuration is first seen (the
+/// winner's frames are used for the capture itself). Odd, so the median
+/// is a real sample; each backend also gets one untimed warm-up grab.
+constexpr int kQuickRuns = 3;
+/// Timed grabs per backend and job mixes per pool size for --calibrate.
+constexpr int kFullRuns = 5;
+
+struct Tuning
+{
+    bool calibrated = false;
+    QString backend;        ///< Empty: the grabber's built-in order
+    int encoderThreads = 0; ///< 0: JobPool sizes itself from the hardware
+    double grabMs = -1;     ///< Median grab time of the chosen backend
+};
+
+/// Identifies the current session type, desktop and screen layout.
+QString configurationKey();
+
+/// Cached tuning for @p key; calibrated is false when there is none.
+Tuning load(const QString &key);
+void store(const QString &key, const Tuning &tuning);
+
+/**
+ * Times every backend of @p grabber over @p runs grabs, after one discarded
+ * warm-up grab each, and returns the one with the lowest median, or an
+ * empty string if none produced frames. The winner's last grab is moved
+ * into @p frames.
+ */
+QString pickBackend(ScreenGrabber *grabber, int runs, double *grabMs, std::vector<CapturedFrame> *frames);
+
+/// Smallest JobPool size whose post-commit job mix on @p sample finishes
+/// within 5% of the fastest size.
+int pickEncoderThreads(const QImage &sample, int runs);
+} // namespace CaptureTuning
+
+#endif // CAPTURETUNING_H
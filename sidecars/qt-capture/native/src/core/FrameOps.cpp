@@ -0,0 +1,51 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "FrameOps.h"
+#include "FramePool.h"
+#include <QBuffer>
+
+QRect FrameOps::toPhysical(const QRectF &logicalRect, qreal devicePixelRatio, const QSize &bounds)
+{
+    int physX = qRound(logicalRect.x() * devicePixelRatio);
+    int physY = qRound(logicalRect.y() * devicePixelRatio);
+    int physW = qRound(logicalRect.width() * devicePixelRatio);
+    int physH = qRound(logicalRect.height() * devicePixelRatio);
+
+    physX = qMax(0, physX);
+    physY = qMax(0, physY);
+
+    if (physX + physW > bounds.width())
+        physW = bounds.width() - physX;
+    if (physY + physH > bounds.height())
+        physH = bounds.height() - physY;
+
+    if (physW <= 0 || physH <= 0)
+        return QRect();
+
+    return QRect(physX, physY, physW, physH);
+}
+
+QImage FrameOps::crop(const QImage &image, const QRectF &logicalRect, qreal devicePixelRatio)
+{
+    const QRect phys = toPhysical(logicalRect, devicePixelRatio, image.size());
+    if (phys.isEmpty())
+        return QImage();
+
+    QImage cropped = FramePool::instance().copy(image, phys);
+    cropped.setDevicePixelRatio(1.0);
+    return cropped;
+}
+
+QByteArray FrameOps::encode(const QImage &image, const char *format, int quality)
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    if (!image.save(&buffer, format, quality))
+        return QByteArray();
+    return data;
+}
@@ -0,0 +1,34 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef FRAMEOPS_H
+#define FRAMEOPS_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QRect>
+#include <QRectF>
+
+/**
+ * Crop and encode helpers shared by the overlay controller and the
+ * capture_core C ABI, so both produce byte-identical results.
+ */
+namespace FrameOps
+{
+/// Maps a logical selection to physical pixels, clamped to @p bounds.
+/// Returns an empty rect when nothing of the selection is left.
+QRect toPhysical(const QRectF &logicalRect, qreal devicePixelRatio, const QSize &bounds);
+
+/// Physical crop of @p image, or a null image for an empty selection.
+QImage crop(const QImage &image, const QRectF &logicalRect, qreal devicePixelRatio);
+
+/// Encodes @p image with Qt's image writers ("PNG", "JPG", ...).
+QByteArray encode(const QImage &image, const char *format, int quality = -1);
+} // namespace FrameOps
+
+#endif // FRAMEOPS_H
@@ -0,0 +1,405 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "FramePool.h"
+#include "LatencyProfile.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#if defined(Q_OS_UNIX)
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+constexpr size_t kAlignment = 64;
+constexpr size_t kPageSize = 4096;
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+size_t roundUp(size_t value, size_t multiple)
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+} // namespace
+
+FramePool &FramePool::instance()
+{
+    // Leaked on purpose: pooled images may outlive static destruction.
+    static FramePool *pool = new FramePool();
+    return *pool;
+}
+
+qsizetype FramePool::strideFor(int width, QImage::Format format)
+{
+    const qsizetype bits = qsizetype(width) * QImage::toPixelFormat(format).bitsPerPixel();
+    const qsizetype bytes = (bits + 7) / 8;
+    return (bytes + qsizetype(kAlignment) - 1) & ~(qsizetype(kAlignment) - 1);
+}
+
+QImage FramePool::acquire(const QSize &size, QImage::Format format)
+{
+    if (size.isEmpty() || format == QImage::Format_Invalid)
+        return QImage();
+
+    QImage target = takeTarget(size, format);
+    if (!target.isNull())
+        return target;
+
+    const qsizetype stride = strideFor(size.width(), format);
+    const Key key{size.width(), size.height(), int(format)};
+
+    bool hit = false;
+    Buffer *buffer = take(key, size_t(stride) * size.height(), &hit);
+    if (!buffer)
+        return QImage();
+
+    return QImage(buffer->data, size.width(), size.height(), stride, format,
+                  &FramePool::recycle, buffer);
+}
+
+void FramePool::setTargets(std::vector<Target> targets, std::vector<QImage::Format> formats)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_targetUsed.assign(targets.size(), false);
+    m_targets = std::move(targets);
+    m_targetFormats = std::move(formats);
+}
+
+QImage FramePool::takeTarget(const QSize &size, QImage::Format format)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (m_targets.empty()
+        || std::find(m_targetFormats.begin(), m_targetFormats.end(), format) == m_targetFormats.end())
+        return QImage();
+
+    const qsizetype rowBytes = qsizetype(size.width()) * QImage::toPixelFormat(format).bitsPerPixel() / 8;
+    for (size_t i = 0; i < m_targets.size(); ++i)
+    {
+        const Target &target = m_targets[i];
+        if (m_targetUsed[i] || target.stride < rowBytes
+            || target.bytes < size_t(target.stride) * size_t(size.height()))
+            continue;
+
+        m_targetUsed[i] = true;
+        return QImage(target.data, size.width(), size.height(), target.stride, format);
+    }
+    return QImage();
+}
+
+QImage FramePool::copy(const QImage &source, const QRect &rect)
+{
+    if (source.isNull())
+        return QImage();
+
+    const QRect area = rect.isNull() ? source.rect() : rect.intersected(source.rect());
+    if (area.isEmpty())
+        return QImage();
+
+    // Sub-byte formats need bit shifting; leave those to Qt.
+    if (source.depth() < 8)
+        return source.copy(area);
+
+    QImage out = acquire(area.size(), source.format());
+    if (out.isNull())
+        return source.copy(area);
+
+    const size_t rowBytes = size_t(area.width()) * (source.depth() / 8);
+    const size_t xOffset = size_t(area.x()) * (source.depth() / 8);
+    for (int y = 0; y < area.height(); ++y)
+        std::memcpy(out.scanLine(y), source.constScanLine(area.y() + y) + xOffset, rowBytes);
+
+    out.setColorTable(source.colorTable());
+    out.setDevicePixelRatio(source.devicePixelRatio());
+    out.setDotsPerMeterX(source.dotsPerMeterX());
+    out.setDotsPerMeterY(source.dotsPerMeterY());
+    return out;
+}
+
+void FramePool::reserve(const QSize &size, QImage::Format format, int count)
+{
+    if (size.isEmpty() || format == QImage::Format_Invalid)
+        return;
+
+    const Key key{size.width(), size.height(), int(format)};
+    const size_t bytes = size_t(strideFor(size.width(), format)) * size.height();
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        ++m_inflight[key];
+    }
+    fill(key, bytes, count);
+}
+
+// Tops the idle list of @p key up to @p count buffers, then drops the
+// in-flight mark the caller took for it.
+void FramePool::fill(const Key &key, size_t bytes, int count)
+{
+    int needed = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto it = m_idle.find(key);
+        needed = count - (it == m_idle.end() ? 0 : int(it->second.size()));
+    }
+
+    // Fault outside the lock so concurrent acquire()/recycle() keep going.
+    std::vector<Buffer *> fresh;
+    for (int i = 0; i < needed; ++i)
+    {
+        if (Buffer *buffer = allocate(key, bytes))
+            fresh.push_back(buffer);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (Buffer *buffer : fresh)
+        {
+            m_stats.residentBytes += bytes;
+            m_stats.idleBytes += bytes;
+            m_idle[key].push_back(buffer);
+            m_idleOrder.push_back(buffer);
+        }
+        if (--m_inflight[key] == 0)
+            m_inflight.erase(key);
+        trimLocked();
+    }
+    m_ready.notify_all();
+}
+
+void FramePool::reserveAsync(std::vector<std::pair<QSize, QImage::Format>> shapes)
+{
+    finishReserve();
+
+    std::vector<std::pair<Key, size_t>> queued;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (const auto &[size, format] : shapes)
+        {
+            if (size.isEmpty() || format == QImage::Format_Invalid)
+                continue;
+            const Key key{size.width(), size.height(), int(format)};
+            ++m_inflight[key];
+            queued.emplace_back(key, size_t(strideFor(size.width(), format)) * size.height());
+        }
+    }
+    if (queued.empty())
+        return;
+
+    m_stopReserve = false;
+    m_reserver = std::thread([this, queued = std::move(queued)]()
+                             {
+                                 LatencyProfile::resetCurrentThread();
+                                 QElapsedTimer clock;
+                                 clock.start();
+                                 const qint64 faultsBefore = threadPageFaults();
+
+                                 // Skipped shapes still have to clear their in-flight mark.
+                                 for (const auto &[key, bytes] : queued)
+                                     fill(key, bytes, m_stopReserve ? 0 : 1);
+
+                                 qDebug() << "[FramePool] Reserved" << queued.size() << "shapes in"
+                                          << clock.nsecsElapsed() / 1e6 << "ms,"
+                                          << (faultsBefore < 0 ? -1 : threadPageFaults() - faultsBefore)
+                                          << "page faults on the reserve thread";
+                             });
+}
+
+void FramePool::finishReserve()
+{
+    m_stopReserve = true;
+    if (m_reserver.joinable())
+        m_reserver.join();
+}
+
+qint64 FramePool::pageFaults()
+{
+#if defined(Q_OS_UNIX)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        return qint64(usage.ru_minflt) + qint64(usage.ru_majflt);
+#endif
+    return -1;
+}
+
+qint64 FramePool::threadPageFaults()
+{
+#if defined(Q_OS_LINUX)
+    rusage usage{};
+    if (getrusage(RUSAGE_THREAD, &usage) == 0)
+        return qint64(usage.ru_minflt) + qint64(usage.ru_majflt);
+    return -1;
+#else
+    return pageFaults();
+#endif
+}
+
+void FramePool::setIdleLimit(uint64_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_idleLimit = bytes;
+    trimLocked();
+}
+
+FramePool::Stats FramePool::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_stats;
+}
+
+void FramePool::logStats() const
+{
+    const Stats s = stats();
+    qDebug() << "[FramePool] hits" << s.hits << "misses" << s.misses
+             << "resident" << s.residentBytes / 1024 << "KiB"
+             << "idle" << s.idleBytes / 1024 << "KiB";
+}
+
+FramePool::Buffer *FramePool::take(const Key &key, size_t bytes, bool *hit)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        for (;;)
+        {
+            auto it = m_idle.find(key);
+            if (it != m_idle.end() && !it->second.empty())
+            {
+                Buffer *buffer = it->second.back();
+                it->second.pop_back();
+                m_idleOrder.erase(std::find(m_idleOrder.begin(), m_idleOrder.end(), buffer));
+                m_stats.idleBytes -= buffer->bytes;
+                ++m_stats.hits;
+                *hit = true;
+                return buffer;
+            }
+            if (!m_inflight.count(key))
+                break;
+            m_ready.wait(lock);
+        }
+        ++m_stats.misses;
+    }
+
+    // Fault the pages in outside the lock; other threads keep recycling.
+    Buffer *buffer = allocate(key, bytes);
+    if (buffer)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_stats.residentBytes += bytes;
+    }
+    *hit = false;
+    return buffer;
+}
+
+void FramePool::giveBack(Buffer *buffer)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_idle[buffer->key].push_back(buffer);
+    m_idleOrder.push_back(buffer);
+    m_stats.idleBytes += buffer->bytes;
+    trimLocked();
+}
+
+void FramePool::trimLocked()
+{
+    while (m_stats.idleBytes > m_idleLimit && !m_idleOrder.empty())
+    {
+        Buffer *oldest = m_idleOrder.front();
+        m_idleOrder.erase(m_idleOrder.begin());
+
+        auto &bucket = m_idle[oldest->key];
+        bucket.erase(std::find(bucket.begin(), bucket.end(), oldest));
+        if (bucket.empty())
+            m_idle.erase(oldest->key);
+
+        m_stats.idleBytes -= oldest->bytes;
+        m_stats.residentBytes -= oldest->bytes;
+        destroy(oldest);
+    }
+}
+
+void FramePool::recycle(void *info)
+{
+    instance().giveBack(static_cast<Buffer *>(info));
+}
+
+FramePool::Buffer *FramePool::allocate(const Key &key, size_t bytes)
+{
+    uchar *data = nullptr;
+    size_t mapped = 0;
+
+#if defined(Q_OS_LINUX)
+    if (m_hugePages.load(std::memory_order_relaxed) && bytes >= kHugePageSize)
+    {
+        // Over-map by one huge page and trim, so the buffer starts on a
+        // 2 MiB boundary and every full 2 MiB extent can be THP backed.
+        mapped = roundUp(bytes, kHugePageSize);
+        void *raw = mmap(nullptr, mapped + kHugePageSize, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED)
+        {
+            mapped = 0;
+        }
+        else
+        {
+            auto *base = static_cast<uchar *>(raw);
+            data = reinterpret_cast<uchar *>(roundUp(reinterpret_cast<uintptr_t>(base), kHugePageSize));
+            if (data > base)
+                munmap(base, size_t(data - base));
+            const size_t tail = size_t(base + mapped + kHugePageSize - (data + mapped));
+            if (tail)
+                munmap(data + mapped, tail);
+            madvise(data, mapped, MADV_HUGEPAGE);
+        }
+    }
+#endif
+
+    if (!data)
+        data = static_cast<uchar *>(::operator new(bytes, std::align_val_t(kAlignment), std::nothrow));
+    if (!data)
+    {
+        qWarning() << "[FramePool] Failed to allocate" << bytes << "bytes";
+        return nullptr;
+    }
+
+    // Touch one byte per page so the first grab does not fault them in.
+    for (size_t offset = 0; offset < bytes; offset += kPageSize)
+        data[offset] = 0;
+
+    auto *buffer = new Buffer{data, bytes, key};
+    buffer->mapped = mapped;
+
+#if defined(Q_OS_UNIX)
+    if (m_lockPages.load(std::memory_order_relaxed))
+    {
+        buffer->locked = mlock(data, bytes) == 0;
+        if (!buffer->locked && m_lockPages.exchange(false))
+            qDebug() << "[FramePool] mlock not permitted (RLIMIT_MEMLOCK), frames stay pageable";
+    }
+#endif
+
+    return buffer;
+}
+
+void FramePool::destroy(Buffer *buffer)
+{
+#if defined(Q_OS_UNIX)
+    if (buffer->locked)
+        munlock(buffer->data, buffer->bytes);
+#endif
+#if defined(Q_OS_LINUX)
+    if (buffer->mapped)
+    {
+        munmap(buffer->data, buffer->mapped);
+        delete buffer;
+        return;
+    }
+#endif
+    ::operator delete(buffer->data, std::align_val_t(kAlignment));
+    delete buffer;
+}
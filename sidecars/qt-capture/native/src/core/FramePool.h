@@ -0,0 +1,148 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef FRAMEPOOL_H
+#define FRAMEPOOL_H
+
+#include <QImage>
+#include <QRect>
+#include <QSize>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Process-wide recycler for multi-megabyte frame buffers.
+ *
+ * Images handed out by acquire()/copy() wrap a pooled, cache-line aligned
+ * buffer; when the last QImage sharing it goes away, Qt's cleanup hook
+ * returns the buffer to the pool instead of the allocator. Buffers are
+ * keyed by exact size and format, so steady-state loops (scroll, record,
+ * watch) and repeated crops reuse already-faulted pages. Idle memory is
+ * capped; the oldest idle buffers are freed beyond the cap.
+ *
+ * On Linux, buffers of 2 MiB and more are mapped 2 MiB aligned and
+ * madvise(MADV_HUGEPAGE)d, so a 4K frame costs ~16 transparent huge page
+ * faults instead of ~8,100 small ones. reserveAsync() pays even those on
+ * a helper thread while the display server is being queried, leaving the
+ * grabbing thread none; acquire() for any shape queued there waits for it
+ * instead of allocating a duplicate.
+ */
+class FramePool
+{
+public:
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t residentBytes = 0; ///< pooled buffers alive, idle or in use
+        uint64_t idleBytes = 0;
+    };
+
+    /// Caller-owned memory acquire() may hand out instead of a pooled buffer.
+    struct Target
+    {
+        uchar *data = nullptr;
+        qsizetype stride = 0;
+        size_t bytes = 0;
+    };
+
+    static FramePool &instance();
+
+    /// Uninitialized image of @p size / @p format backed by a pooled buffer.
+    QImage acquire(const QSize &size, QImage::Format format);
+
+    /// Pooled deep copy of @p rect of @p source (the whole image by default).
+    QImage copy(const QImage &source, const QRect &rect = QRect());
+
+    /**
+     * Until cleared with an empty list, acquire() and copy() place an image
+     * in one of @p formats into the first unused target it fits, so a grab
+     * lands directly in memory the caller owns. Such images have no cleanup
+     * hook and must not outlive the target.
+     */
+    void setTargets(std::vector<Target> targets, std::vector<QImage::Format> formats);
+
+    /// Allocates and pre-faults @p count idle buffers for a known frame shape.
+    void reserve(const QSize &size, QImage::Format format, int count);
+
+    /// reserve() one buffer per shape on a helper thread. Every shape counts
+    /// as in flight from the start, not just the one being faulted in.
+    void reserveAsync(std::vector<std::pair<QSize, QImage::Format>> shapes);
+
+    /// Skips shapes reserveAsync() has not started and joins its thread.
+    /// Call before leaving main(); the pool itself is never destroyed.
+    void finishReserve();
+
+    /// Back large buffers with transparent huge pages (Linux, on by default).
+    void setHugePages(bool enabled) { m_hugePages = enabled; }
+
+    /// Minor + major page faults of this process so far, or -1 if unknown.
+    static qint64 pageFaults();
+
+    /// Same for the calling thread only (Linux; elsewhere the process), so
+    /// a measurement excludes the reserve thread's prefaulting.
+    static qint64 threadPageFaults();
+
+    void setIdleLimit(uint64_t bytes);
+
+    /// mlock() buffers allocated from now on; disabled again on first failure.
+    void setLockPages(bool enabled) { m_lockPages = enabled; }
+    Stats stats() const;
+    void logStats() const;
+
+private:
+    using Key = std::tuple<int, int, int>;
+
+    struct Buffer
+    {
+        uchar *data = nullptr;
+        size_t bytes = 0;
+        Key key;
+        bool locked = false;
+        size_t mapped = 0; ///< non-zero for mmap()ed huge-page buffers
+    };
+
+    FramePool() = default;
+
+    static qsizetype strideFor(int width, QImage::Format format);
+    static void recycle(void *info);
+
+    QImage takeTarget(const QSize &size, QImage::Format format);
+    Buffer *take(const Key &key, size_t bytes, bool *hit);
+    void giveBack(Buffer *buffer);
+    void trimLocked();
+    Buffer *allocate(const Key &key, size_t bytes);
+    void fill(const Key &key, size_t bytes, int count);
+    static void destroy(Buffer *buffer);
+
+    mutable std::mutex m_lock;
+    std::map<Key, std::vector<Buffer *>> m_idle;
+    std::vector<Buffer *> m_idleOrder;
+    uint64_t m_idleLimit = 256ull * 1024 * 1024;
+    std::atomic<bool> m_lockPages{false};
+    std::atomic<bool> m_hugePages{true};
+    std::map<Key, int> m_inflight;
+    std::condition_variable m_ready;
+    Stats m_stats;
+
+    std::vector<Target> m_targets;
+    std::vector<bool> m_targetUsed;
+    std::vector<QImage::Format> m_targetFormats;
+
+    std::thread m_reserver;
+    std::atomic<bool> m_stopReserve{false};
+};
+
+#endif // FRAMEPOOL_H
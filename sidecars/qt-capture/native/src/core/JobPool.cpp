@@ -0,0 +1,96 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "JobPool.h"
+#include "LatencyProfile.h"
+#include <QDebug>
+#include <algorithm>
+
+JobPool::JobPool(int threads)
+{
+    if (threads <= 0)
+        threads = std::clamp(int(std::thread::hardware_concurrency()), 2, 4);
+
+    m_threads.reserve(threads);
+    for (int i = 0; i < threads; ++i)
+        m_threads.emplace_back(&JobPool::run, this);
+}
+
+JobPool::~JobPool()
+{
+    shutdown();
+}
+
+void JobPool::submit(std::function<void()> fn, Clock::time_point deadline)
+{
+    Job job{std::move(fn), deadline};
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (!m_stopping)
+        {
+            m_queue.push_back(std::move(job));
+            m_wake.notify_one();
+            return;
+        }
+    }
+
+    // After shutdown there are no workers left: the job runs inline.
+    finish(job);
+}
+
+void JobPool::finish(const Job &job)
+{
+    job.fn();
+    m_completed.fetch_add(1, std::memory_order_relaxed);
+    if (Clock::now() > job.deadline)
+        m_late.fetch_add(1, std::memory_order_relaxed);
+}
+
+void JobPool::run()
+{
+    LatencyProfile::resetCurrentThread();
+    for (;;)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_wake.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+            if (m_queue.empty())
+                return;
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        finish(job);
+    }
+}
+
+void JobPool::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (m_stopping)
+            return;
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread &thread : m_threads)
+    {
+        if (thread.joinable())
+            thread.join();
+    }
+
+    const Stats s = stats();
+    qDebug() << "[JobPool] completed" << s.completed << "late" << s.late;
+}
+
+JobPool::Stats JobPool::stats() const
+{
+    Stats s;
+    s.completed = m_completed.load(std::memory_order_relaxed);
+    s.late = m_late.load(std::memory_order_relaxed);
+    return s;
+}
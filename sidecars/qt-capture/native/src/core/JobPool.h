@@ -0,0 +1,77 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef JOBPOOL_H
+#define JOBPOOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Small FIFO thread pool for post-capture jobs.
+ *
+ * Every job the host waits for (the full encode and write, the preview, the
+ * code scan) goes through one shared queue, oldest first. Jobs carry a
+ * deadline; one that finishes after it is still delivered but counted as
+ * late. shutdown() runs whatever is still queued before joining, and jobs
+ * submitted afterwards run inline on the caller.
+ */
+class JobPool
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats
+    {
+        uint64_t completed = 0;
+        uint64_t late = 0;
+    };
+
+    /// @p threads <= 0 picks a size from the hardware concurrency (2..4).
+    explicit JobPool(int threads = 0);
+    ~JobPool();
+
+    JobPool(const JobPool &) = delete;
+    JobPool &operator=(const JobPool &) = delete;
+
+    void submit(std::function<void()> fn, Clock::time_point deadline = Clock::time_point::max());
+
+    /// Runs the remaining jobs and joins.
+    void shutdown();
+
+    Stats stats() const;
+
+private:
+    struct Job
+    {
+        std::function<void()> fn;
+        Clock::time_point deadline;
+    };
+
+    void run();
+    void finish(const Job &job);
+
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_lock;
+    std::condition_variable m_wake;
+    std::deque<Job> m_queue;
+    bool m_stopping = false;
+
+    std::atomic<uint64_t> m_completed{0};
+    std::atomic<uint64_t> m_late{0};
+};
+
+#endif // JOBPOOL_H
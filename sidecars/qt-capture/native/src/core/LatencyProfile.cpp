@@ -0,0 +1,200 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "LatencyProfile.h"
+#include "FramePool.h"
+#include <QDebug>
+#include <QFile>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+
+#if defined(Q_OS_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#elif defined(Q_OS_UNIX)
+#include <pthread.h>
+#include <sys/resource.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#endif
+
+namespace {
+
+constexpr int kNiceLevel = -10;
+constexpr int kRealtimePriority = 10;
+constexpr int kPinnedCores = 2;
+constexpr unsigned long kSampleMs = 25;
+// Qt Quick renders on demand; longer gaps are idle time, not slow frames.
+constexpr qint64 kIdleGapUs = 250000;
+
+std::atomic<bool> g_applied{false};
+
+#if defined(Q_OS_LINUX)
+std::vector<int> g_quietCores;
+cpu_set_t g_processCores;
+
+/// Per-CPU idle+iowait jiffies from /proc/stat, indexed by CPU number.
+std::vector<quint64> readIdleJiffies(std::vector<quint64> *totals)
+{
+    std::vector<quint64> idle;
+    QFile stat("/proc/stat");
+    if (!stat.open(QIODevice::ReadOnly))
+        return idle;
+
+    const QList<QByteArray> lines = stat.readAll().split('\n');
+    for (const QByteArray &line : lines)
+    {
+        if (!line.startsWith("cpu") || line.startsWith("cpu "))
+            continue;
+
+        const QList<QByteArray> fields = line.simplified().split(' ');
+        if (fields.size() < 6)
+            continue;
+
+        quint64 total = 0;
+        for (int i = 1; i < fields.size(); ++i)
+            total += fields[i].toULongLong();
+        idle.push_back(fields[4].toULongLong() + fields[5].toULongLong());
+        totals->push_back(total);
+    }
+    return idle;
+}
+
+std::vector<int> sampleQuietCores()
+{
+    std::vector<quint64> totalsBefore, totalsAfter;
+    const std::vector<quint64> before = readIdleJiffies(&totalsBefore);
+    QThread::msleep(kSampleMs);
+    const std::vector<quint64> after = readIdleJiffies(&totalsAfter);
+
+    if (before.empty() || before.size() != after.size())
+        return {};
+
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+
+    std::vector<std::pair<double, int>> ranked;
+    for (size_t cpu = 0; cpu < before.size(); ++cpu)
+    {
+        if (!CPU_ISSET(int(cpu), &allowed))
+            continue;
+        const quint64 span = totalsAfter[cpu] - totalsBefore[cpu];
+        const double idleShare = span ? double(after[cpu] - before[cpu]) / double(span) : 1.0;
+        ranked.emplace_back(idleShare, int(cpu));
+    }
+
+    std::sort(ranked.begin(), ranked.end(), [](const auto &a, const auto &b)
+              { return a.first > b.first; });
+
+    std::vector<int> cores;
+    for (size_t i = 0; i < ranked.size() && int(i) < kPinnedCores; ++i)
+        cores.push_back(ranked[i].second);
+    return cores;
+}
+#endif
+
+} // namespace
+
+void LatencyProfile::applyToProcess()
+{
+#if defined(Q_OS_UNIX)
+    if (setpriority(PRIO_PROCESS, 0, kNiceLevel) == 0)
+        qDebug() << "[LatencyProfile] Process nice level" << kNiceLevel;
+    else
+        qDebug() << "[LatencyProfile] Cannot raise nice level, keeping default";
+#elif defined(Q_OS_WIN)
+    if (SetPriorityClass(GetCurrentProcess(), ABOVE_NORMAL_PRIORITY_CLASS))
+        qDebug() << "[LatencyProfile] Process priority class raised";
+#endif
+
+#if defined(Q_OS_LINUX)
+    CPU_ZERO(&g_processCores);
+    sched_getaffinity(0, sizeof(g_processCores), &g_processCores);
+    g_quietCores = sampleQuietCores();
+    qDebug() << "[LatencyProfile] Quietest cores:" << QList<int>(g_quietCores.begin(), g_quietCores.end());
+#endif
+
+    FramePool::instance().setLockPages(true);
+    g_applied = true;
+}
+
+void LatencyProfile::applyToCurrentThread(const char *role)
+{
+#if defined(Q_OS_LINUX)
+    sched_param param{};
+    param.sched_priority = kRealtimePriority;
+    if (pthread_setschedparam(pthread_self(), SCHED_RR, &param) == 0)
+        qDebug() << "[LatencyProfile]" << role << "thread on SCHED_RR" << kRealtimePriority;
+    else
+        qDebug() << "[LatencyProfile]" << role << "thread: SCHED_RR not permitted, keeping SCHED_OTHER";
+
+    if (!g_quietCores.empty())
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : g_quietCores)
+            CPU_SET(cpu, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+            qDebug() << "[LatencyProfile]" << role << "thread: affinity not applied";
+    }
+#elif defined(Q_OS_WIN)
+    if (SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST))
+        qDebug() << "[LatencyProfile]" << role << "thread priority raised";
+#else
+    Q_UNUSED(role);
+#endif
+}
+
+void LatencyProfile::resetCurrentThread()
+{
+    if (!g_applied)
+        return;
+
+#if defined(Q_OS_LINUX)
+    sched_param param{};
+    pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+    pthread_setaffinity_np(pthread_self(), sizeof(g_processCores), &g_processCores);
+#endif
+}
+
+void FrameTimeRecorder::tick()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (m_clock.isValid())
+    {
+        const qint64 interval = m_clock.nsecsElapsed() / 1000;
+        if (interval < kIdleGapUs)
+            m_intervalsUs.push_back(interval);
+    }
+    m_clock.start();
+}
+
+void FrameTimeRecorder::report() const
+{
+    std::vector<qint64> sorted;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        sorted = m_intervalsUs;
+    }
+    if (sorted.empty())
+        return;
+
+    std::sort(sorted.begin(), sorted.end());
+    auto pct = [&sorted](double p)
+    {
+        const size_t i = std::min(sorted.size() - 1, size_t(p * double(sorted.size())));
+        return double(sorted[i]) / 1000.0;
+    };
+
+    qInfo().nospace() << "[FrameTime] " << m_label << ": " << sorted.size() << " frames"
+                      << " p50 " << pct(0.50) << " ms"
+                      << " p95 " << pct(0.95) << " ms"
+                      << " p99 " << pct(0.99) << " ms"
+                      << " max " << double(sorted.back()) / 1000.0 << " ms";
+}
@@ -0,0 +1,64 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef LATENCYPROFILE_H
+#define LATENCYPROFILE_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <mutex>
+#include <vector>
+
+/**
+ * Opt-in, experimental scheduling profile meant for machines under heavy
+ * background load. Whether it lowers p99/max frame or input-to-paint
+ * latency has not been measured yet; compare --latency-stats runs with and
+ * without it before relying on it.
+ *
+ * Every step is best effort: without CAP_SYS_NICE, RLIMIT_RTPRIO or a
+ * large enough RLIMIT_MEMLOCK the corresponding step is skipped with a
+ * debug note and capture proceeds with default scheduling.
+ */
+namespace LatencyProfile
+{
+/// Raises process priority, samples /proc/stat to choose the quietest
+/// cores, and makes the frame pool mlock() its buffers.
+void applyToProcess();
+
+/// SCHED_RR (or a high thread priority) plus pinning to the chosen cores
+/// for the calling thread. Call from the GUI thread and the render thread.
+void applyToCurrentThread(const char *role);
+
+/// Back to SCHED_OTHER on every core the process started with. Threads
+/// inherit policy and affinity from their creator, so background workers
+/// call this first; a no-op unless the profile was applied.
+void resetCurrentThread();
+} // namespace LatencyProfile
+
+/**
+ * @brief Collects frame-to-frame intervals for tail latency reporting.
+ *
+ * tick() may be called from the render thread; report() prints the
+ * p50/p95/p99/max interval to the debug log.
+ */
+class FrameTimeRecorder
+{
+public:
+    explicit FrameTimeRecorder(const QString &label) : m_label(label) {}
+
+    void tick();
+    void report() const;
+
+private:
+    QString m_label;
+    mutable std::mutex m_lock;
+    QElapsedTimer m_clock;
+    std::vector<qint64> m_intervalsUs;
+};
+
+#endif // LATENCYPROFILE_H
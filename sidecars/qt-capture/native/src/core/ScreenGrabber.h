@@ -10,10 +10,14 @@
 #define SCREENGRABBER_H
 
 #include <vector>
+#include <optional>
 #include <QImage>
 #include <QRect>
 #include <QString>
+#include <QStringList>
 #include <QObject>
+#include <QPixmap>
+#include <QScreen>
 #include <algorithm>
 
 struct CapturedFrame
@@ -23,6 +27,8 @@ struct CapturedFrame
     qreal devicePixelRatio;
     int index;
     QString name;
+    /// index of the frame this output mirrors (same pixels, image shared), or -1
+    int mirrorOf = -1;
 };
 
 class ScreenGrabber : public QObject
@@ -33,11 +39,78 @@ public:
     explicit ScreenGrabber(QObject *parent = nullptr) : QObject(parent) {}
     virtual ~ScreenGrabber() = default;
     virtual std::vector<CapturedFrame> captureAll() = 0;
+
+    /**
+     * Grab paths that can be timed against each other without user
+     * interaction (no portal dialogs), in default preference order.
+     * Backends with a single fixed path return nothing.
+     */
+    virtual QStringList backends() const { return {}; }
+
+    /**
+     * captureAll() through one named backend only; nothing when that path
+     * is unavailable or fails.
+     */
+    virtual std::vector<CapturedFrame> captureWith(const QString &backend)
+    {
+        Q_UNUSED(backend);
+        return {};
+    }
+
+    /// Backend captureAll() tries first (e.g. a calibrated winner).
+    void setPreferredBackend(const QString &backend) { m_preferredBackend = backend; }
+
+    /**
+     * Geometry of the visible windows in native desktop coordinates, ordered
+     * bottom-to-top. Backends that cannot enumerate windows return nothing,
+     * which simply disables window snapping in the overlay.
+     */
+    virtual std::vector<QRect> windowGeometries() { return {}; }
+
+    /**
+     * Captures only the pixels of one native window, unaffected by whatever
+     * overlaps it. Returns nothing when the backend has no such path.
+     */
+    virtual std::optional<CapturedFrame> captureWindow(quint64 windowId)
+    {
+        Q_UNUSED(windowId);
+        return std::nullopt;
+    }
+
+    /**
+     * Live grab of @p rect (logical, relative to @p screen) for modes that
+     * sample the screen repeatedly after the overlay is gone.
+     */
+    virtual QImage grabRegion(QScreen *screen, const QRect &rect)
+    {
+        if (!screen)
+            return QImage();
+        return screen->grabWindow(0, rect.x(), rect.y(), rect.width(), rect.height()).toImage();
+    }
+
+    /**
+     * Index of an already captured frame showing the same desktop area at
+     * the same scale (a cloned/mirrored output), or -1.
+     */
+    static int findMirror(const std::vector<CapturedFrame> &frames, const QRect &geometry, qreal devicePixelRatio)
+    {
+        for (const CapturedFrame &frame : frames)
+        {
+            if (frame.mirrorOf < 0 && frame.geometry == geometry
+                && qFuzzyCompare(frame.devicePixelRatio, devicePixelRatio))
+                return frame.index;
+        }
+        return -1;
+    }
+
     static void sortLeftToRight(std::vector<CapturedFrame> &frames)
     {
         std::sort(frames.begin(), frames.end(), [](const CapturedFrame &a, const CapturedFrame &b)
                   { return a.geometry.x() < b.geometry.x(); });
     }
+
+protected:
+    QString m_preferredBackend;
 };
 
 #endif // SCREENGRABBER_H
@@ -0,0 +1,188 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "SessionFile.h"
+#include <QDebug>
+#include <QFile>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+uint64_t alignToPage(uint64_t offset)
+{
+    return (offset + SessionFile::kPageSize - 1) & ~uint64_t(SessionFile::kPageSize - 1);
+}
+
+/// Grabbers deliver 32-bit frames; anything else is converted once here.
+QImage storedImage(const QImage &image)
+{
+    if (SessionFile::isStoredFormat(uint32_t(image.format())))
+        return image;
+    return image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                         : QImage::Format_RGB32);
+}
+}
+
+bool SessionFile::isStoredFormat(uint32_t format)
+{
+    switch (QImage::Format(format))
+    {
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+    case QImage::Format_RGBX8888:
+    case QImage::Format_RGBA8888:
+    case QImage::Format_RGBA8888_Premultiplied:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool SessionFile::write(const QString &path, const std::vector<CapturedFrame> &frames)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "[SessionFile] Cannot open" << path;
+        return false;
+    }
+
+    SessionHeader header{};
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.frameCount = uint32_t(frames.size());
+    header.pageSize = kPageSize;
+    header.recordSize = sizeof(SessionFrameRecord);
+
+    std::vector<QImage> images;
+    images.reserve(frames.size());
+    for (const CapturedFrame &frame : frames)
+        images.push_back(storedImage(frame.image));
+
+    std::vector<SessionFrameRecord> records(frames.size());
+    uint64_t offset = alignToPage(sizeof(SessionHeader) + records.size() * sizeof(SessionFrameRecord));
+
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        const CapturedFrame &frame = frames[i];
+        const QImage &image = images[i];
+        SessionFrameRecord &rec = records[i];
+        rec.x = frame.geometry.x();
+        rec.y = frame.geometry.y();
+        rec.width = frame.geometry.width();
+        rec.height = frame.geometry.height();
+        rec.devicePixelRatio = frame.devicePixelRatio;
+        rec.index = frame.index;
+        rec.pixelFormat = uint32_t(image.format());
+        rec.pixelWidth = uint32_t(image.width());
+        rec.pixelHeight = uint32_t(image.height());
+        rec.stride = uint32_t(image.bytesPerLine());
+        rec.planeOffset = offset;
+        rec.planeSize = uint64_t(image.sizeInBytes());
+
+        const QByteArray name = frame.name.toUtf8().left(kNameLength - 1);
+        memcpy(rec.name, name.constData(), size_t(name.size()));
+
+        offset = alignToPage(offset + rec.planeSize);
+    }
+    header.fileSize = offset;
+
+    bool ok = file.write(reinterpret_cast<const char *>(&header), sizeof(header)) == sizeof(header);
+    for (const SessionFrameRecord &rec : records)
+        ok = ok && file.write(reinterpret_cast<const char *>(&rec), sizeof(rec)) == sizeof(rec);
+
+    for (size_t i = 0; ok && i < frames.size(); ++i)
+    {
+        const qint64 pad = qint64(records[i].planeOffset) - file.pos();
+        ok = file.write(QByteArray(pad, '\0')) == pad
+            && file.write(reinterpret_cast<const char *>(images[i].constBits()),
+                          qint64(records[i].planeSize)) == qint64(records[i].planeSize);
+    }
+    ok = ok && file.resize(qint64(header.fileSize));
+
+    if (!ok)
+        qWarning() << "[SessionFile] Failed to write session to" << path;
+    return ok;
+}
+
+class SessionGrabber : public ScreenGrabber
+{
+public:
+    SessionGrabber(const QString &path, QObject *parent) : ScreenGrabber(parent), m_file(path) {}
+
+    std::vector<CapturedFrame> captureAll() override
+    {
+        std::vector<CapturedFrame> frames;
+        if (!m_file.isOpen() && !m_file.open(QIODevice::ReadOnly))
+        {
+            qCritical() << "[SessionFile] Cannot open" << m_file.fileName();
+            return frames;
+        }
+
+        const qint64 size = m_file.size();
+        const uchar *base = m_file.map(0, size);
+        if (!base || size < qint64(sizeof(SessionFile::SessionHeader)))
+        {
+            qCritical() << "[SessionFile] Cannot map" << m_file.fileName();
+            return frames;
+        }
+
+        const auto *header = reinterpret_cast<const SessionFile::SessionHeader *>(base);
+        const uint64_t recordsEnd = sizeof(SessionFile::SessionHeader)
+            + uint64_t(header->frameCount) * sizeof(SessionFile::SessionFrameRecord);
+
+        if (memcmp(header->magic, SessionFile::kMagic, sizeof(SessionFile::kMagic)) != 0
+            || header->version != SessionFile::kVersion
+            || header->recordSize != sizeof(SessionFile::SessionFrameRecord)
+            || recordsEnd > uint64_t(size))
+        {
+            qCritical() << "[SessionFile] Not a supported session file:" << m_file.fileName();
+            return frames;
+        }
+
+        const auto *records = reinterpret_cast<const SessionFile::SessionFrameRecord *>(base + sizeof(*header));
+        for (uint32_t i = 0; i < header->frameCount; ++i)
+        {
+            const SessionFile::SessionFrameRecord &rec = records[i];
+            // Written so no sum or product can wrap: offset and size are
+            // checked separately, the 32-bit factors multiply in 64 bits.
+            if (rec.planeOffset > uint64_t(size) || rec.planeSize > uint64_t(size) - rec.planeOffset
+                || !SessionFile::isStoredFormat(rec.pixelFormat)
+                || rec.pixelWidth == 0 || rec.pixelHeight == 0
+                || rec.pixelWidth > uint32_t(std::numeric_limits<int>::max())
+                || rec.pixelHeight > uint32_t(std::numeric_limits<int>::max())
+                || rec.stride < uint64_t(rec.pixelWidth) * 4
+                || uint64_t(rec.stride) * rec.pixelHeight > rec.planeSize)
+            {
+                qWarning() << "[SessionFile] Skipping corrupt frame record" << i;
+                continue;
+            }
+
+            CapturedFrame frame;
+            frame.image = QImage(base + rec.planeOffset, int(rec.pixelWidth), int(rec.pixelHeight),
+                                 qsizetype(rec.stride), QImage::Format(rec.pixelFormat));
+            frame.geometry = QRect(rec.x, rec.y, rec.width, rec.height);
+            frame.devicePixelRatio = rec.devicePixelRatio;
+            frame.image.setDevicePixelRatio(frame.devicePixelRatio);
+            frame.index = rec.index;
+            frame.name = QString::fromUtf8(rec.name, int(strnlen(rec.name, SessionFile::kNameLength)));
+            frames.push_back(frame);
+        }
+
+        ScreenGrabber::sortLeftToRight(frames);
+        return frames;
+    }
+
+private:
+    QFile m_file;
+};
+
+ScreenGrabber *createSessionEngine(const QString &path, QObject *parent)
+{
+    return new SessionGrabber(path, parent);
+}
@@ -0,0 +1,87 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef SESSIONFILE_H
+#define SESSIONFILE_H
+
+#include <QString>
+#include <cstdint>
+#include <vector>
+
+#include "ScreenGrabber.h"
+
+/**
+ * @brief Versioned raw dump of a capture session.
+ *
+ * Layout (little-endian):
+ *
+ *     SessionHeader
+ *     SessionFrameRecord[frameCount]
+ *     padding to kPageSize
+ *     plane 0 (page-aligned, stride * height bytes, 4 bytes per pixel)
+ *     plane 1 ...
+ *
+ * Planes are stored exactly as the frames' QImage buffers, so a reader can
+ * mmap the file and wrap each plane without parsing or copying.
+ */
+namespace SessionFile
+{
+constexpr char kMagic[8] = {'Q', 'C', 'A', 'P', 'S', 'E', 'S', 'S'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kPageSize = 4096;
+constexpr int kNameLength = 64;
+
+struct SessionHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t frameCount;
+    uint32_t pageSize;
+    uint32_t recordSize;
+    uint64_t fileSize;
+};
+
+struct SessionFrameRecord
+{
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+    double devicePixelRatio;
+    int32_t index;
+    uint32_t pixelFormat; // QImage::Format
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t stride;
+    uint32_t reserved;
+    uint64_t planeOffset;
+    uint64_t planeSize;
+    char name[kNameLength]; // UTF-8, NUL padded
+};
+
+static_assert(sizeof(SessionHeader) == 32, "SessionHeader layout changed");
+static_assert(sizeof(SessionFrameRecord) == 128, "SessionFrameRecord layout changed");
+
+/// True for the formats planes are stored in: one 32-bit word per pixel,
+/// so a reader can check stride and plane size without knowing the layout.
+bool isStoredFormat(uint32_t format);
+
+/**
+ * Writes @p frames in one sequential pass. Planes are stored in one of the
+ * 32-bit QImage formats; other frames are converted first.
+ */
+bool write(const QString &path, const std::vector<CapturedFrame> &frames);
+} // namespace SessionFile
+
+/**
+ * Grabber that replays a session file instead of touching the screen.
+ * Frames alias the mapped file; nothing is decoded or copied.
+ */
+ScreenGrabber *createSessionEngine(const QString &path, QObject *parent);
+
+#endif // SESSIONFILE_H
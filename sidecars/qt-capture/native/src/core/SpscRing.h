@@ -0,0 +1,64 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief Bounded lock-free ring for exactly one producer and one consumer.
+ *
+ * Used to hand frames from the GUI thread to a worker without a mutex on
+ * the hot path. Capacity must be a power of two.
+ */
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+
+public:
+    bool push(T value)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == Capacity)
+            return false;
+
+        m_slots[head & (Capacity - 1)] = std::move(value);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &out)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire))
+            return false;
+
+        out = std::move(m_slots[tail & (Capacity - 1)]);
+        m_slots[tail & (Capacity - 1)] = T();
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool isEmpty() const
+    {
+        return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire);
+    }
+
+private:
+    std::array<T, Capacity> m_slots{};
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+};
+
+#endif // SPSCRING_H
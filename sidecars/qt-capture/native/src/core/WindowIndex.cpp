@@ -0,0 +1,69 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "WindowIndex.h"
+
+void WindowIndex::build(std::vector<QRect> rects)
+{
+    m_rects = std::move(rects);
+    m_bounds = QRect();
+    for (const QRect &r : m_rects)
+        m_bounds = m_bounds.united(r);
+
+    m_cols = 0;
+    m_rows = 0;
+    m_cellOffsets.clear();
+    m_cellEntries.clear();
+
+    if (m_rects.empty() || m_bounds.isEmpty())
+        return;
+
+    m_cols = (m_bounds.width() + kCellSize - 1) / kCellSize;
+    m_rows = (m_bounds.height() + kCellSize - 1) / kCellSize;
+
+    auto forEachCell = [this](const QRect &r, auto &&fn)
+    {
+        const int c0 = (r.left() - m_bounds.left()) / kCellSize;
+        const int c1 = (r.right() - m_bounds.left()) / kCellSize;
+        const int r0 = (r.top() - m_bounds.top()) / kCellSize;
+        const int r1 = (r.bottom() - m_bounds.top()) / kCellSize;
+        for (int row = r0; row <= r1; ++row)
+            for (int col = c0; col <= c1; ++col)
+                fn(cellIndex(col, row));
+    };
+
+    // Two passes into a flat CSR layout: count, then fill. Entries stay in
+    // stacking order inside every bucket, so the last match is the topmost.
+    m_cellOffsets.assign(static_cast<size_t>(m_cols) * m_rows + 1, 0);
+    for (const QRect &r : m_rects)
+        forEachCell(r, [this](int cell) { ++m_cellOffsets[cell + 1]; });
+
+    for (size_t i = 1; i < m_cellOffsets.size(); ++i)
+        m_cellOffsets[i] += m_cellOffsets[i - 1];
+
+    m_cellEntries.resize(m_cellOffsets.back());
+    std::vector<int> cursor(m_cellOffsets.begin(), m_cellOffsets.end() - 1);
+    for (int i = 0; i < static_cast<int>(m_rects.size()); ++i)
+        forEachCell(m_rects[i], [&](int cell) { m_cellEntries[cursor[cell]++] = i; });
+}
+
+QRect WindowIndex::hitTest(const QPoint &point) const
+{
+    if (m_cols == 0 || !m_bounds.contains(point))
+        return QRect();
+
+    const int col = (point.x() - m_bounds.left()) / kCellSize;
+    const int row = (point.y() - m_bounds.top()) / kCellSize;
+    const int cell = cellIndex(col, row);
+
+    for (int i = m_cellOffsets[cell + 1] - 1; i >= m_cellOffsets[cell]; --i)
+    {
+        const QRect &r = m_rects[m_cellEntries[i]];
+        if (r.contains(point))
+            return r;
+    }
+    return QRect();
+}
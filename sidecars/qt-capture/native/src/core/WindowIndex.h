@@ -0,0 +1,48 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef WINDOWINDEX_H
+#define WINDOWINDEX_H
+
+#include <vector>
+#include <QPoint>
+#include <QRect>
+
+/**
+ * @brief Uniform grid over window geometries for pointer hit tests.
+ *
+ * Built once from a bottom-to-top list of window rectangles in native
+ * desktop coordinates. Each grid cell keeps the indices of the windows that
+ * overlap it, so a hit test only scans one short bucket instead of the whole
+ * window tree and never talks to the display server.
+ */
+class WindowIndex
+{
+public:
+    void build(std::vector<QRect> rects);
+
+    /// Topmost rectangle containing @p point, or an invalid QRect.
+    QRect hitTest(const QPoint &point) const;
+
+    bool isEmpty() const { return m_rects.empty(); }
+    size_t size() const { return m_rects.size(); }
+
+private:
+    static constexpr int kCellSize = 128;
+
+    int cellIndex(int col, int row) const { return row * m_cols + col; }
+
+    QRect m_bounds;
+    int m_cols = 0;
+    int m_rows = 0;
+    std::vector<QRect> m_rects;
+    std::vector<int> m_cellOffsets;
+    std::vector<int> m_cellEntries;
+};
+
+#endif // WINDOWINDEX_H
@@ -0,0 +1,146 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ApngWriter.h"
+#include <QDebug>
+
+namespace
+{
+QByteArray animationControl(quint32 frames)
+{
+    QByteArray actl;
+    PngChunk::appendU32(actl, frames);
+    PngChunk::appendU32(actl, 0); // loop forever
+    return actl;
+}
+}
+
+ApngWriter::~ApngWriter()
+{
+    close();
+}
+
+void ApngWriter::close()
+{
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+bool ApngWriter::open(const QString &path, const QSize &size)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (size.isEmpty() || !m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "[ApngWriter] Cannot open" << path;
+        return false;
+    }
+
+    m_size = size;
+    m_sequence = 0;
+    m_frames = 0;
+
+    m_file.write(PngChunk::kSignature, sizeof(PngChunk::kSignature));
+    return PngChunk::write(m_file, "IHDR", PngChunk::header(quint32(size.width()), quint32(size.height()), 2))
+        && PngChunk::write(m_file, "acTL", animationControl(0));
+}
+
+QByteArray ApngWriter::deflateRows(const QImage &patch)
+{
+    const QImage source = patch.convertToFormat(QImage::Format_RGB32);
+    const int rowBytes = source.width() * 3;
+
+    QByteArray raw;
+    raw.resize(qsizetype(rowBytes + 1) * source.height());
+    uchar *out = reinterpret_cast<uchar *>(raw.data());
+
+    for (int y = 0; y < source.height(); ++y)
+    {
+        const QRgb *px = reinterpret_cast<const QRgb *>(source.constScanLine(y));
+        const QRgb *up = y > 0 ? reinterpret_cast<const QRgb *>(source.constScanLine(y - 1)) : nullptr;
+
+        *out++ = up ? 2 : 0; // "Up" filter after the first row
+        for (int x = 0; x < source.width(); ++x)
+        {
+            const QRgb above = up ? up[x] : 0;
+            *out++ = uchar(qRed(px[x]) - qRed(above));
+            *out++ = uchar(qGreen(px[x]) - qGreen(above));
+            *out++ = uchar(qBlue(px[x]) - qBlue(above));
+        }
+    }
+
+    uLongf length = compressBound(uLong(raw.size()));
+    QByteArray compressed;
+    compressed.resize(qsizetype(length));
+    if (compress2(reinterpret_cast<Bytef *>(compressed.data()), &length,
+                  reinterpret_cast<const Bytef *>(raw.constData()), uLong(raw.size()), Z_BEST_SPEED) != Z_OK)
+        return QByteArray();
+
+    compressed.resize(qsizetype(length));
+    return compressed;
+}
+
+bool ApngWriter::addFrame(const QImage &patch, const QRect &rect, int delayMs)
+{
+    if (!m_file.isOpen())
+        return false;
+    if (m_frames == 0 && rect != QRect(QPoint(0, 0), m_size))
+        return false;
+
+    const QByteArray data = deflateRows(patch);
+    if (data.isEmpty())
+        return false;
+
+    QByteArray fctl;
+    PngChunk::appendU32(fctl, m_sequence++);
+    PngChunk::appendU32(fctl, quint32(rect.width()));
+    PngChunk::appendU32(fctl, quint32(rect.height()));
+    PngChunk::appendU32(fctl, quint32(rect.x()));
+    PngChunk::appendU32(fctl, quint32(rect.y()));
+    PngChunk::appendU16(fctl, quint16(qBound(1, delayMs, 65535)));
+    PngChunk::appendU16(fctl, 1000);
+    fctl.append(char(0)); // dispose: none
+    fctl.append(char(0)); // blend: source
+
+    if (!PngChunk::write(m_file, "fcTL", fctl))
+        return false;
+
+    bool ok;
+    if (m_frames == 0)
+    {
+        ok = PngChunk::write(m_file, "IDAT", data);
+    }
+    else
+    {
+        QByteArray fdat;
+        fdat.reserve(data.size() + 4);
+        PngChunk::appendU32(fdat, m_sequence++);
+        fdat.append(data);
+        ok = PngChunk::write(m_file, "fdAT", fdat);
+    }
+
+    if (ok)
+        ++m_frames;
+    return ok;
+}
+
+bool ApngWriter::finish()
+{
+    if (!m_file.isOpen() || m_frames == 0)
+    {
+        close();
+        return false;
+    }
+
+    bool ok = PngChunk::write(m_file, "IEND", QByteArray());
+
+    ok = ok && m_file.seek(kActlOffset)
+        && PngChunk::write(m_file, "acTL", animationControl(quint32(m_frames)));
+
+    close();
+    return ok;
+}
@@ -0,0 +1,60 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef APNGWRITER_H
+#define APNGWRITER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QImage>
+#include <QRect>
+#include <QString>
+
+#include "PngChunk.h"
+
+/**
+ * @brief Streaming animated PNG encoder with sub-rectangle frames.
+ *
+ * Every frame after the first only carries the rectangle that changed and
+ * is composited over the previous one (dispose none, blend source), which
+ * is how APNG expresses inter-frame deltas. Frames go to disk as they are
+ * added; the frame count in acTL is patched on finish.
+ */
+class ApngWriter
+{
+public:
+    ApngWriter() = default;
+    ~ApngWriter();
+
+    ApngWriter(const ApngWriter &) = delete;
+    ApngWriter &operator=(const ApngWriter &) = delete;
+
+    bool open(const QString &path, const QSize &size);
+
+    /**
+     * Appends a frame. @p patch holds the pixels of @p rect; the first frame
+     * must cover the whole canvas.
+     */
+    bool addFrame(const QImage &patch, const QRect &rect, int delayMs);
+    bool finish();
+
+    int frameCount() const { return m_frames; }
+
+private:
+    static QByteArray deflateRows(const QImage &patch);
+    void close();
+
+    static constexpr qint64 kActlOffset = sizeof(PngChunk::kSignature) + 12 + 13;
+
+    QFile m_file;
+    QSize m_size;
+    quint32 m_sequence = 0;
+    int m_frames = 0;
+};
+
+#endif // APNGWRITER_H
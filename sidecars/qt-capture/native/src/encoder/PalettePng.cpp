@@ -0,0 +1,247 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "PalettePng.h"
+#include "PngChunk.h"
+#include <QDebug>
+#include <QFile>
+#include <array>
+#include <cstdint>
+
+namespace
+{
+constexpr int kTableBits = 10;
+constexpr int kTableSize = 1 << kTableBits;
+constexpr QRgb kOpaque = 0xff000000u;
+
+/**
+ * Open-addressed colour -> palette index map. Four slots per possible
+ * entry keep probe chains short without any allocation.
+ */
+class ColorTable
+{
+public:
+    ColorTable() { m_index.fill(-1); }
+
+    int find(QRgb color) const
+    {
+        for (uint32_t slot = bucket(color);; slot = (slot + 1) & (kTableSize - 1))
+        {
+            if (m_index[slot] < 0)
+                return -1;
+            if (m_key[slot] == color)
+                return m_index[slot];
+        }
+    }
+
+    void insert(QRgb color, int index)
+    {
+        uint32_t slot = bucket(color);
+        while (m_index[slot] >= 0)
+            slot = (slot + 1) & (kTableSize - 1);
+        m_key[slot] = color;
+        m_index[slot] = int16_t(index);
+    }
+
+private:
+    static uint32_t bucket(QRgb color) { return (color * 0x9E3779B1u) >> (32 - kTableBits); }
+
+    std::array<QRgb, kTableSize> m_key{};
+    std::array<int16_t, kTableSize> m_index;
+};
+
+/**
+ * Length of the run of @p color at the start of @p pixels. Screen content
+ * is dominated by flat runs; the eight-lane OR of XORs compiles to a
+ * vector compare on SSE/AVX and NEON, so runs are skipped 8 pixels at a
+ * time before any table lookup happens.
+ */
+inline int sameRun(const QRgb *pixels, int count, QRgb color, QRgb mask)
+{
+    constexpr int kLanes = 8;
+    int i = 0;
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        QRgb diff = 0;
+        for (int l = 0; l < kLanes; ++l)
+            diff |= (pixels[i + l] | mask) ^ color;
+        if (diff)
+            break;
+    }
+    while (i < count && (pixels[i] | mask) == color)
+        ++i;
+    return i;
+}
+
+/// Non-premultiplied 32-bit view. RGB32 is used as is; its alpha byte is
+/// masked to opaque on read because X servers leave it undefined.
+QImage argbSource(const QImage &image, QRgb &mask)
+{
+    mask = 0;
+    if (image.format() == QImage::Format_RGB32)
+    {
+        mask = kOpaque;
+        return image;
+    }
+    if (image.format() == QImage::Format_ARGB32)
+        return image;
+    return image.convertToFormat(QImage::Format_ARGB32);
+}
+
+int bitDepthFor(int colors)
+{
+    if (colors <= 2)
+        return 1;
+    if (colors <= 4)
+        return 2;
+    if (colors <= 16)
+        return 4;
+    return 8;
+}
+} // namespace
+
+bool PalettePng::histogram(const QImage &image, QVector<QRgb> &palette)
+{
+    palette.clear();
+    if (image.isNull())
+        return false;
+
+    QRgb mask = 0;
+    const QImage source = argbSource(image, mask);
+    const int width = source.width();
+
+    ColorTable table;
+    QRgb last = (reinterpret_cast<const QRgb *>(source.constScanLine(0))[0]) | mask;
+    table.insert(last, 0);
+    palette.append(last);
+
+    for (int y = 0; y < source.height(); ++y)
+    {
+        const QRgb *row = reinterpret_cast<const QRgb *>(source.constScanLine(y));
+        int x = 0;
+        while (x < width)
+        {
+            x += sameRun(row + x, width - x, last, mask);
+            if (x >= width)
+                break;
+
+            last = row[x] | mask;
+            if (table.find(last) < 0)
+            {
+                if (palette.size() == kMaxColors)
+                    return false;
+                table.insert(last, int(palette.size()));
+                palette.append(last);
+            }
+            ++x;
+        }
+    }
+    return true;
+}
+
+bool PalettePng::write(const QImage &image, const QVector<QRgb> &palette, const QString &path)
+{
+    if (image.isNull() || palette.isEmpty() || palette.size() > kMaxColors)
+        return false;
+
+    // Translucent entries first so tRNS can stop at the last one of them.
+    QVector<QRgb> ordered;
+    ordered.reserve(palette.size());
+    for (QRgb color : palette)
+        if (qAlpha(color) != 255)
+            ordered.append(color);
+    const int translucent = int(ordered.size());
+    for (QRgb color : palette)
+        if (qAlpha(color) == 255)
+            ordered.append(color);
+
+    ColorTable table;
+    for (int i = 0; i < ordered.size(); ++i)
+        table.insert(ordered[i], i);
+
+    QRgb mask = 0;
+    const QImage source = argbSource(image, mask);
+    const int width = source.width();
+    const int height = source.height();
+    const int depth = bitDepthFor(int(ordered.size()));
+    const int rowBytes = (width * depth + 7) / 8;
+
+    // Filter type 0 on every row, as the PNG spec recommends for palettes.
+    QByteArray raw(qsizetype(rowBytes + 1) * height, '\0');
+    uchar *out = reinterpret_cast<uchar *>(raw.data());
+
+    QRgb lastColor = ordered.front();
+    int lastIndex = 0;
+    for (int y = 0; y < height; ++y)
+    {
+        const QRgb *row = reinterpret_cast<const QRgb *>(source.constScanLine(y));
+        uchar *indices = out + qsizetype(y) * (rowBytes + 1) + 1;
+
+        for (int x = 0; x < width; ++x)
+        {
+            const QRgb color = row[x] | mask;
+            if (color != lastColor)
+            {
+                lastIndex = table.find(color);
+                if (lastIndex < 0)
+                {
+                    qWarning() << "[PalettePng] Colour missing from palette";
+                    return false;
+                }
+                lastColor = color;
+            }
+
+            if (depth == 8)
+                indices[x] = uchar(lastIndex);
+            else
+                indices[(x * depth) >> 3] |= uchar(lastIndex << (8 - depth - ((x * depth) & 7)));
+        }
+    }
+
+    // Index data is a quarter of the RGBA size or less, so the strongest
+    // deflate level stays cheaper than Qt's default truecolour encode.
+    uLongf length = compressBound(uLong(raw.size()));
+    QByteArray compressed;
+    compressed.resize(qsizetype(length));
+    if (compress2(reinterpret_cast<Bytef *>(compressed.data()), &length,
+                  reinterpret_cast<const Bytef *>(raw.constData()), uLong(raw.size()), Z_BEST_COMPRESSION) != Z_OK)
+        return false;
+    compressed.resize(qsizetype(length));
+
+    QByteArray plte;
+    plte.reserve(ordered.size() * 3);
+    for (QRgb color : ordered)
+    {
+        plte.append(char(qRed(color)));
+        plte.append(char(qGreen(color)));
+        plte.append(char(qBlue(color)));
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "[PalettePng] Cannot open" << path;
+        return false;
+    }
+
+    bool ok = file.write(PngChunk::kSignature, sizeof(PngChunk::kSignature)) == qint64(sizeof(PngChunk::kSignature))
+        && PngChunk::write(file, "IHDR", PngChunk::header(quint32(width), quint32(height), 3, quint8(depth)))
+        && PngChunk::write(file, "PLTE", plte);
+
+    if (ok && translucent > 0)
+    {
+        QByteArray trns;
+        trns.reserve(translucent);
+        for (int i = 0; i < translucent; ++i)
+            trns.append(char(qAlpha(ordered[i])));
+        ok = PngChunk::write(file, "tRNS", trns);
+    }
+
+    ok = ok && PngChunk::write(file, "IDAT", compressed)
+        && PngChunk::write(file, "IEND", QByteArray());
+    file.close();
+    return ok;
+}
@@ -0,0 +1,43 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef PALETTEPNG_H
+#define PALETTEPNG_H
+
+#include <QImage>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Lossless indexed PNG output for crops with few distinct colours.
+ *
+ * UI and text captures rarely use more than a handful of colours, so a
+ * palette (1/2/4/8-bit indices) is an exact and much smaller encoding than
+ * 32-bit RGBA. The histogram stops at the first colour past the limit, so
+ * photographic content costs only the rows scanned until then before the
+ * caller falls back to truecolour.
+ */
+namespace PalettePng
+{
+inline constexpr int kMaxColors = 256;
+
+/**
+ * Collects the distinct ARGB colours of @p image (non-premultiplied).
+ * Returns false as soon as more than kMaxColors are seen; @p palette is
+ * left in an unspecified state then.
+ */
+bool histogram(const QImage &image, QVector<QRgb> &palette);
+
+/**
+ * Writes @p image as an indexed PNG using @p palette, which must contain
+ * every colour of the image (as produced by histogram()).
+ */
+bool write(const QImage &image, const QVector<QRgb> &palette, const QString &path);
+} // namespace PalettePng
+
+#endif // PALETTEPNG_H
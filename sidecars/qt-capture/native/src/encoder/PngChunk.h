@@ -0,0 +1,80 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef PNGCHUNK_H
+#define PNGCHUNK_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QtEndian>
+
+#if __has_include(<zlib.h>)
+#include <zlib.h>
+#else
+#include <QtZlib/zlib.h>
+#endif
+
+/**
+ * Minimal PNG chunk plumbing shared by the streaming encoders. Qt's PNG
+ * writer needs the whole image up front; these helpers let us emit chunks
+ * as data becomes available.
+ */
+namespace PngChunk
+{
+inline constexpr char kSignature[8] = {'\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n'};
+
+inline void appendU32(QByteArray &out, quint32 value)
+{
+    const quint32 be = qToBigEndian(value);
+    out.append(reinterpret_cast<const char *>(&be), 4);
+}
+
+inline void appendU16(QByteArray &out, quint16 value)
+{
+    const quint16 be = qToBigEndian(value);
+    out.append(reinterpret_cast<const char *>(&be), 2);
+}
+
+/// Serialized chunk: length, type, payload, CRC over type + payload.
+inline QByteArray make(const char type[4], const char *data, int length)
+{
+    QByteArray chunk;
+    chunk.reserve(length + 12);
+    appendU32(chunk, quint32(length));
+    chunk.append(type, 4);
+    chunk.append(data, length);
+
+    uLong crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, reinterpret_cast<const Bytef *>(chunk.constData() + 4), uInt(length + 4));
+    appendU32(chunk, quint32(crc));
+    return chunk;
+}
+
+inline bool write(QIODevice &device, const char type[4], const QByteArray &payload)
+{
+    const QByteArray chunk = make(type, payload.constData(), int(payload.size()));
+    return device.write(chunk) == chunk.size();
+}
+
+/// IHDR payload for an image of the given PNG colour type (8-bit unless
+/// a smaller palette depth is requested).
+inline QByteArray header(quint32 width, quint32 height, quint8 colorType, quint8 bitDepth = 8)
+{
+    QByteArray ihdr;
+    appendU32(ihdr, width);
+    appendU32(ihdr, height);
+    ihdr.append(char(bitDepth));  // bit depth
+    ihdr.append(char(colorType)); // 2 = RGB, 3 = palette, 6 = RGBA
+    ihdr.append(char(0));         // deflate
+    ihdr.append(char(0));         // adaptive filtering
+    ihdr.append(char(0));         // no interlace
+    return ihdr;
+}
+} // namespace PngChunk
+
+#endif // PNGCHUNK_H
@@ -0,0 +1,145 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "PngStreamWriter.h"
+#include <QDebug>
+
+PngStreamWriter::~PngStreamWriter()
+{
+    abort();
+}
+
+void PngStreamWriter::abort()
+{
+    if (m_streamOpen)
+    {
+        deflateEnd(&m_stream);
+        m_streamOpen = false;
+    }
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+bool PngStreamWriter::open(const QString &path, int width)
+{
+    abort();
+
+    m_file.setFileName(path);
+    if (width <= 0 || !m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "[PngStreamWriter] Cannot open" << path;
+        return false;
+    }
+
+    m_width = width;
+    m_height = 0;
+    m_row = QByteArray(width * 3, '\0');
+    m_prevRow = QByteArray(width * 3, '\0');
+    m_filtered = QByteArray(width * 3 + 1, '\0');
+    m_idat.clear();
+
+    m_stream = z_stream{};
+    if (deflateInit(&m_stream, Z_DEFAULT_COMPRESSION) != Z_OK)
+        return false;
+    m_streamOpen = true;
+
+    m_file.write(PngChunk::kSignature, sizeof(PngChunk::kSignature));
+    return PngChunk::write(m_file, "IHDR", PngChunk::header(quint32(width), 0, 2));
+}
+
+bool PngStreamWriter::appendRows(const QImage &image, int firstRow, int rowCount)
+{
+    if (!m_streamOpen || image.width() != m_width)
+        return false;
+
+    const QImage source = image.format() == QImage::Format_RGB32 || image.format() == QImage::Format_ARGB32
+        ? image
+        : image.convertToFormat(QImage::Format_RGB32);
+
+    uchar *row = reinterpret_cast<uchar *>(m_row.data());
+    const uchar *prev = reinterpret_cast<const uchar *>(m_prevRow.constData());
+    uchar *out = reinterpret_cast<uchar *>(m_filtered.data());
+
+    for (int y = firstRow; y < firstRow + rowCount; ++y)
+    {
+        const QRgb *px = reinterpret_cast<const QRgb *>(source.constScanLine(y));
+        for (int x = 0; x < m_width; ++x)
+        {
+            row[x * 3 + 0] = uchar(qRed(px[x]));
+            row[x * 3 + 1] = uchar(qGreen(px[x]));
+            row[x * 3 + 2] = uchar(qBlue(px[x]));
+        }
+
+        // "Up" filter: UI content is mostly vertically coherent.
+        out[0] = 2;
+        for (int i = 0; i < m_width * 3; ++i)
+            out[i + 1] = uchar(row[i] - prev[i]);
+
+        if (!deflateInput(out, size_t(m_filtered.size()), Z_NO_FLUSH))
+            return false;
+
+        std::swap(m_row, m_prevRow);
+        row = reinterpret_cast<uchar *>(m_row.data());
+        prev = reinterpret_cast<const uchar *>(m_prevRow.constData());
+        ++m_height;
+    }
+    return true;
+}
+
+bool PngStreamWriter::deflateInput(const uchar *data, size_t length, int flush)
+{
+    m_stream.next_in = const_cast<Bytef *>(data);
+    m_stream.avail_in = uInt(length);
+
+    uchar buffer[16384];
+    int ret = Z_OK;
+    do
+    {
+        m_stream.next_out = buffer;
+        m_stream.avail_out = sizeof(buffer);
+        ret = deflate(&m_stream, flush);
+        if (ret == Z_STREAM_ERROR)
+            return false;
+
+        m_idat.append(reinterpret_cast<const char *>(buffer), int(sizeof(buffer) - m_stream.avail_out));
+        if (m_idat.size() >= kIdatSize && !flushIdat())
+            return false;
+    } while (m_stream.avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+
+    return true;
+}
+
+bool PngStreamWriter::flushIdat()
+{
+    if (m_idat.isEmpty())
+        return true;
+    const bool ok = PngChunk::write(m_file, "IDAT", m_idat);
+    m_idat.clear();
+    return ok;
+}
+
+bool PngStreamWriter::finish()
+{
+    if (!m_streamOpen || m_height == 0)
+    {
+        abort();
+        return false;
+    }
+
+    const bool ok = deflateInput(nullptr, 0, Z_FINISH) && flushIdat()
+        && PngChunk::write(m_file, "IEND", QByteArray());
+
+    deflateEnd(&m_stream);
+    m_streamOpen = false;
+
+    // Rewrite IHDR now that the height is known.
+    const QByteArray ihdr = PngChunk::make("IHDR", PngChunk::header(quint32(m_width), quint32(m_height), 2).constData(), 13);
+    const bool patched = m_file.seek(kIhdrOffset)
+        && m_file.write(ihdr) == ihdr.size();
+
+    m_file.close();
+    return ok && patched;
+}
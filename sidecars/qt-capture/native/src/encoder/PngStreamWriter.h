@@ -0,0 +1,62 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef PNGSTREAMWRITER_H
+#define PNGSTREAMWRITER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QImage>
+#include <QString>
+
+#include "PngChunk.h"
+
+/**
+ * @brief Row-at-a-time PNG encoder for images of unknown final height.
+ *
+ * Rows are filtered and deflated as soon as they are appended and flushed
+ * to disk in IDAT chunks, so memory stays constant no matter how tall the
+ * image grows. The height in IHDR is patched when the stream is finished.
+ * Output is 8-bit RGB, which is what opaque screen content needs.
+ */
+class PngStreamWriter
+{
+public:
+    PngStreamWriter() = default;
+    ~PngStreamWriter();
+
+    PngStreamWriter(const PngStreamWriter &) = delete;
+    PngStreamWriter &operator=(const PngStreamWriter &) = delete;
+
+    bool open(const QString &path, int width);
+    bool appendRows(const QImage &image, int firstRow, int rowCount);
+    bool finish();
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+private:
+    bool deflateInput(const uchar *data, size_t length, int flush);
+    bool flushIdat();
+    void abort();
+
+    static constexpr int kIdatSize = 64 * 1024;
+    static constexpr qint64 kIhdrOffset = sizeof(PngChunk::kSignature);
+
+    QFile m_file;
+    z_stream m_stream{};
+    bool m_streamOpen = false;
+    QByteArray m_idat;
+    QByteArray m_row;
+    QByteArray m_prevRow;
+    QByteArray m_filtered;
+    int m_width = 0;
+    int m_height = 0;
+};
+
+#endif // PNGSTREAMWRITER_H
@@ -5,6 +5,7 @@
  */
 
 #include "ScreenGrabber.h"
+#include "FramePool.h"
 #include <QGuiApplication>
 #include <QScreen>
 #include <QPixmap>
@@ -19,8 +20,31 @@
 #include <QUrl>
 #include <QFile>
 #include <QTimer>
+#include <QtGui/qguiapplication_platform.h>
+#include "X11WindowTree.h"
+#include "X11WindowCapture.h"
+#include "XcbShmImage.h"
+#include <memory>
+#if defined(CAPTURE_HAVE_WLR_SCREENCOPY)
+#include "WlrScreencopy.h"
+#endif
+#if defined(CAPTURE_HAVE_PIPEWIRE)
+#include "PipeWireScreencast.h"
+#endif
 #endif
 #include <cmath>
+
+#if defined(Q_OS_LINUX)
+namespace {
+
+// Names of the X11 grab paths, as stored in the tuning cache.
+constexpr char kBackendShm[] = "xcb-shm";
+constexpr char kBackendGetImage[] = "xcb-getimage";
+constexpr char kBackendQt[] = "qt";
+
+} // namespace
+#endif
+
 #if defined(Q_OS_LINUX)
 class PortalHelper : public QObject
 {
@@ -56,10 +80,38 @@ public:
 
     std::vector<CapturedFrame> captureAll() override
     {
+        if (!m_preferredBackend.isEmpty())
+        {
+            std::vector<CapturedFrame> frames = captureWith(m_preferredBackend);
+            if (!frames.empty())
+            {
+                qDebug() << "Captured via tuned backend" << m_preferredBackend;
+                return frames;
+            }
+            qWarning() << "Tuned backend" << m_preferredBackend << "failed, using the default order.";
+        }
+
 #if defined(Q_OS_LINUX)
         QString sessionType = qgetenv("XDG_SESSION_TYPE").toLower();
         if (sessionType == "wayland")
         {
+            std::vector<CapturedFrame> frames;
+#if defined(CAPTURE_HAVE_WLR_SCREENCOPY)
+            frames = captureWlrScreencopy();
+            if (!frames.empty())
+            {
+                qDebug() << "Wayland session detected, captured via wlr-screencopy.";
+                return frames;
+            }
+#endif
+#if defined(CAPTURE_HAVE_PIPEWIRE)
+            frames = captureScreencast();
+            if (!frames.empty())
+            {
+                qDebug() << "Wayland session detected, captured via ScreenCast portal.";
+                return frames;
+            }
+#endif
             qDebug() << "Wayland session detected, using Portal capture.";
             return captureWayland();
         }
@@ -74,8 +126,140 @@ public:
 #endif
     }
 
+    QStringList backends() const override
+    {
+#if defined(Q_OS_LINUX)
+        // Wayland has one non-interactive path (wlr-screencopy); the
+        // portals would show a dialog per timed grab.
+        if (qgetenv("XDG_SESSION_TYPE").toLower() == "wayland")
+            return {};
+
+        auto *x11 = qGuiApp->nativeInterface<QNativeInterface::QX11Application>();
+        if (!x11 || !x11->connection())
+            return {};
+        return {kBackendShm, kBackendGetImage, kBackendQt};
+#else
+        return {};
+#endif
+    }
+
+    std::vector<CapturedFrame> captureWith(const QString &backend) override
+    {
+        if (!backends().contains(backend))
+            return {};
+        return captureStandard(backend);
+    }
+
+    std::vector<QRect> windowGeometries() override
+    {
+#if defined(Q_OS_LINUX)
+        if (qgetenv("XDG_SESSION_TYPE").toLower() == "wayland")
+            return {};
+
+        auto *x11 = qGuiApp->nativeInterface<QNativeInterface::QX11Application>();
+        if (!x11 || !x11->connection())
+            return {};
+
+        xcb_connection_t *conn = x11->connection();
+        xcb_window_t root = xcb_setup_roots_iterator(xcb_get_setup(conn)).data->root;
+        return queryX11WindowTree(conn, root);
+#else
+        return {};
+#endif
+    }
+
+    std::optional<CapturedFrame> captureWindow(quint64 windowId) override
+    {
+#if defined(Q_OS_LINUX)
+        if (qgetenv("XDG_SESSION_TYPE").toLower() == "wayland")
+        {
+            qWarning() << "Window capture is only available on X11.";
+            return std::nullopt;
+        }
+
+        auto *x11 = qGuiApp->nativeInterface<QNativeInterface::QX11Application>();
+        if (!x11 || !x11->connection())
+            return std::nullopt;
+
+        QRect nativeGeometry;
+        QImage image = captureX11Window(x11->connection(), xcb_window_t(windowId), &nativeGeometry);
+        if (image.isNull())
+            return std::nullopt;
+
+        QScreen *screen = QGuiApplication::screenAt(nativeGeometry.center());
+        if (!screen)
+            screen = QGuiApplication::primaryScreen();
+
+        CapturedFrame frame;
+        frame.image = image;
+        frame.devicePixelRatio = screen ? screen->devicePixelRatio() : 1.0;
+        frame.geometry = QRect(nativeGeometry.topLeft(),
+                               (QSizeF(nativeGeometry.size()) / frame.devicePixelRatio).toSize());
+        frame.image.setDevicePixelRatio(frame.devicePixelRatio);
+        frame.name = screen ? screen->name() : QString();
+        frame.index = 0;
+        return frame;
+#else
+        Q_UNUSED(windowId);
+        return std::nullopt;
+#endif
+    }
+
+    QImage grabRegion(QScreen *screen, const QRect &rect) override
+    {
+#if defined(Q_OS_LINUX)
+        // Repeated live grabs on X11 go through one persistent MIT-SHM
+        // segment instead of a QPixmap round trip per frame.
+        auto *x11 = qGuiApp->nativeInterface<QNativeInterface::QX11Application>();
+        if (screen && x11 && x11->connection() && qgetenv("XDG_SESSION_TYPE").toLower() != "wayland")
+        {
+            xcb_connection_t *conn = x11->connection();
+            if (!m_shm)
+                m_shm = std::make_unique<XcbShmImage>(conn);
+
+            const qreal dpr = screen->devicePixelRatio();
+            const QRect native(screen->geometry().topLeft() + (QPointF(rect.topLeft()) * dpr).toPoint(),
+                               (QSizeF(rect.size()) * dpr).toSize());
+            xcb_window_t root = xcb_setup_roots_iterator(xcb_get_setup(conn)).data->root;
+            return FramePool::instance().copy(m_shm->grab(root, native));
+        }
+#endif
+        return ScreenGrabber::grabRegion(screen, rect);
+    }
+
 private:
-    std::vector<CapturedFrame> captureStandard()
+#if defined(Q_OS_LINUX)
+    std::unique_ptr<XcbShmImage> m_shm;
+    std::unique_ptr<XcbShmImage> m_plain;
+
+    /**
+     * Whole-screen grab through one X11 path. An empty @p backend is the
+     * default: MIT-SHM, falling back to GetImage without the extension.
+     */
+    QImage grabScreen(QScreen *screen, const QString &backend)
+    {
+        const QRect full(QPoint(0, 0), screen->geometry().size());
+        if (backend == kBackendQt)
+            return ScreenGrabber::grabRegion(screen, full);
+        if (backend != kBackendGetImage)
+            return grabRegion(screen, full);
+
+        auto *x11 = qGuiApp->nativeInterface<QNativeInterface::QX11Application>();
+        if (!x11 || !x11->connection())
+            return QImage();
+
+        xcb_connection_t *conn = x11->connection();
+        if (!m_plain)
+            m_plain = std::make_unique<XcbShmImage>(conn, false);
+
+        const QRect native(screen->geometry().topLeft(),
+                           (QSizeF(full.size()) * screen->devicePixelRatio()).toSize());
+        xcb_window_t root = xcb_setup_roots_iterator(xcb_get_setup(conn)).data->root;
+        return FramePool::instance().copy(m_plain->grab(root, native));
+    }
+#endif
+
+    std::vector<CapturedFrame> captureStandard(const QString &backend = QString())
     {
         std::vector<CapturedFrame> frames;
         const auto screens = QGuiApplication::screens();
@@ -85,12 +269,36 @@ private:
         {
             if (!screen)
                 continue;
-            QPixmap pixmap = screen->grabWindow(0);
-            if (pixmap.isNull())
+
+            // Cloned outputs read the same root area: grab it once and
+            // share the image instead of copying identical pixels again.
+            const int mirror = ScreenGrabber::findMirror(frames, screen->geometry(), screen->devicePixelRatio());
+            if (mirror >= 0)
+            {
+                auto source = std::find_if(frames.begin(), frames.end(), [mirror](const CapturedFrame &f)
+                                           { return f.index == mirror; });
+                CapturedFrame frame = *source;
+                frame.name = screen->name();
+                frame.index = index++;
+                frame.mirrorOf = mirror;
+                qDebug() << "Screen" << frame.name << "mirrors" << source->name << "- sharing its frame";
+                frames.push_back(frame);
+                continue;
+            }
+
+#if defined(Q_OS_LINUX)
+            // On X11 grab straight into a pooled buffer through MIT-SHM
+            // rather than QPixmap plus toImage(), two fresh allocations.
+            QImage image = grabScreen(screen, backend);
+#else
+            Q_UNUSED(backend);
+            QImage image = screen->grabWindow(0).toImage();
+#endif
+            if (image.isNull())
                 continue;
 
             CapturedFrame frame;
-            frame.image = pixmap.toImage();
+            frame.image = image;
             frame.geometry = screen->geometry();
             frame.devicePixelRatio = screen->devicePixelRatio();
             frame.image.setDevicePixelRatio(frame.devicePixelRatio);
@@ -102,6 +310,23 @@ private:
         return frames;
     }
 
+#if defined(Q_OS_LINUX) && defined(CAPTURE_HAVE_PIPEWIRE)
+    std::vector<CapturedFrame> captureScreencast()
+    {
+        // Testing hook: read one node of the local daemon, skipping the
+        // portal (e.g. a videotestsrc ! pipewiresink source).
+        bool ok = false;
+        const uint node = qEnvironmentVariable("QT_CAPTURE_PIPEWIRE_NODE").toUInt(&ok);
+        if (ok)
+        {
+            ScreencastStream stream;
+            stream.nodeId = node;
+            return capturePipeWireStreams(-1, {stream});
+        }
+        return captureScreencastPortal();
+    }
+#endif
+
 #if defined(Q_OS_LINUX)
     std::vector<CapturedFrame> captureWayland()
     {
@@ -197,7 +422,7 @@ private:
             if (cropY + cropH > fullDesktop.height())
                 cropH = fullDesktop.height() - cropY;
 
-            QImage screenImg = fullDesktop.copy(cropX, cropY, cropW, cropH);
+            QImage screenImg = FramePool::instance().copy(fullDesktop, QRect(cropX, cropY, cropW, cropH));
             screenImg.setDevicePixelRatio(scaleFactor);
 
             CapturedFrame frame;
@@ -5,6 +5,7 @@
  */
 
 #include "ScreenGrabber.h"
+#include "FramePool.h"
 #include <QDebug>
 #include <QGuiApplication>
 #include <QScreen>
@@ -96,7 +97,7 @@ private:
             QImage qtImage(static_cast<uchar *>(bitmapData.Scan0), w, h,
                            bitmapData.Stride, QImage::Format_ARGB32);
 
-            QImage safeImage = qtImage.copy();
+            QImage safeImage = FramePool::instance().copy(qtImage);
 
             CapturedFrame frame;
             frame.image = safeImage;
@@ -0,0 +1,431 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "PipeWireScreencast.h"
+#include "FramePool.h"
+#include <QDBusArgument>
+#include <QDBusConnection>
+#include <QDBusInterface>
+#include <QDBusObjectPath>
+#include <QDBusReply>
+#include <QDBusUnixFileDescriptor>
+#include <QDebug>
+#include <QEventLoop>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QSettings>
+#include <QTimer>
+#include <QUuid>
+#include <memory>
+#include <unistd.h>
+#include <pipewire/pipewire.h>
+#include <spa/param/video/format-utils.h>
+#include <spa/param/buffers.h>
+
+namespace {
+
+constexpr int kPortalTimeoutMs = 30000; // includes the first-run picker
+constexpr int kFrameTimeoutSec = 2;
+constexpr uint32_t kSourceMonitor = 1;
+constexpr uint32_t kCursorHidden = 1;
+constexpr uint32_t kPersistUntilRevoked = 2;
+const char *kRestoreTokenKey = "screencast/restoreToken";
+
+const char *kPortalService = "org.freedesktop.portal.Desktop";
+const char *kPortalPath = "/org/freedesktop/portal/desktop";
+
+QString newToken()
+{
+    return "qtcapture" + QUuid::createUuid().toString(QUuid::Id128);
+}
+
+QPoint pointFromVariant(const QVariant &value)
+{
+    int x = 0, y = 0;
+    const QDBusArgument arg = value.value<QDBusArgument>();
+    arg.beginStructure();
+    arg >> x >> y;
+    arg.endStructure();
+    return QPoint(x, y);
+}
+
+} // namespace
+
+/**
+ * @brief Waits for the Response of one portal Request object.
+ *
+ * Subscribes to the predicted request path before the call is made, so a
+ * fast response cannot be missed.
+ */
+class PortalRequest : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PortalRequest(const QString &token)
+    {
+        QString sender = QDBusConnection::sessionBus().baseService().mid(1);
+        sender.replace('.', '_');
+        m_path = QString("/org/freedesktop/portal/desktop/request/%1/%2").arg(sender, token);
+        QDBusConnection::sessionBus().connect(kPortalService, m_path, "org.freedesktop.portal.Request",
+                                              "Response", this, SLOT(handleResponse(uint, QVariantMap)));
+    }
+
+    ~PortalRequest() override
+    {
+        QDBusConnection::sessionBus().disconnect(kPortalService, m_path, "org.freedesktop.portal.Request",
+                                                 "Response", this, SLOT(handleResponse(uint, QVariantMap)));
+    }
+
+    bool wait()
+    {
+        if (!m_done)
+        {
+            QEventLoop loop;
+            connect(this, &PortalRequest::finished, &loop, &QEventLoop::quit);
+            QTimer::singleShot(kPortalTimeoutMs, &loop, &QEventLoop::quit);
+            loop.exec();
+        }
+        return m_done && response == 0;
+    }
+
+    uint response = 2;
+    QVariantMap results;
+
+public slots:
+    void handleResponse(uint code, const QVariantMap &values)
+    {
+        response = code;
+        results = values;
+        m_done = true;
+        emit finished();
+    }
+
+signals:
+    void finished();
+
+private:
+    QString m_path;
+    bool m_done = false;
+};
+
+std::vector<CapturedFrame> captureScreencastPortal()
+{
+    QDBusInterface portal(kPortalService, kPortalPath, "org.freedesktop.portal.ScreenCast");
+    if (!portal.isValid())
+        return {};
+
+    // CreateSession
+    QString token = newToken();
+    PortalRequest create(token);
+    QVariantMap options;
+    options["handle_token"] = token;
+    options["session_handle_token"] = newToken();
+    QDBusReply<QDBusObjectPath> reply = portal.call("CreateSession", options);
+    if (!reply.isValid() || !create.wait())
+    {
+        qWarning() << "[Screencast] CreateSession failed";
+        return {};
+    }
+    const QDBusObjectPath session(create.results.value("session_handle").toString());
+
+    auto closeSession = [&session]()
+    {
+        QDBusInterface(kPortalService, session.path(), "org.freedesktop.portal.Session").call("Close");
+    };
+
+    // SelectSources, restoring the previous selection when we have a token
+    QSettings settings;
+    token = newToken();
+    PortalRequest select(token);
+    options.clear();
+    options["handle_token"] = token;
+    options["types"] = kSourceMonitor;
+    options["multiple"] = true;
+    options["cursor_mode"] = kCursorHidden;
+    options["persist_mode"] = kPersistUntilRevoked;
+    const QString restoreToken = settings.value(kRestoreTokenKey).toString();
+    if (!restoreToken.isEmpty())
+        options["restore_token"] = restoreToken;
+    reply = portal.call("SelectSources", QVariant::fromValue(session), options);
+    if (!reply.isValid() || !select.wait())
+    {
+        qWarning() << "[Screencast] SelectSources failed";
+        closeSession();
+        return {};
+    }
+
+    // Start
+    token = newToken();
+    PortalRequest start(token);
+    options.clear();
+    options["handle_token"] = token;
+    reply = portal.call("Start", QVariant::fromValue(session), QString(), options);
+    if (!reply.isValid() || !start.wait())
+    {
+        qWarning() << "[Screencast] Start failed or was declined";
+        closeSession();
+        return {};
+    }
+
+    // Tokens are single use; every Start hands out the next one.
+    const QString nextToken = start.results.value("restore_token").toString();
+    if (!nextToken.isEmpty())
+        settings.setValue(kRestoreTokenKey, nextToken);
+
+    std::vector<ScreencastStream> streams;
+    const QDBusArgument streamArg = start.results.value("streams").value<QDBusArgument>();
+    streamArg.beginArray();
+    while (!streamArg.atEnd())
+    {
+        ScreencastStream stream;
+        QVariantMap props;
+        streamArg.beginStructure();
+        streamArg >> stream.nodeId >> props;
+        streamArg.endStructure();
+        if (props.contains("position"))
+            stream.position = pointFromVariant(props.value("position"));
+        if (props.contains("size"))
+        {
+            const QPoint size = pointFromVariant(props.value("size"));
+            stream.size = QSize(size.x(), size.y());
+        }
+        streams.push_back(stream);
+    }
+    streamArg.endArray();
+
+    QDBusReply<QDBusUnixFileDescriptor> remote =
+        portal.call("OpenPipeWireRemote", QVariant::fromValue(session), QVariantMap());
+    if (!remote.isValid() || streams.empty())
+    {
+        qWarning() << "[Screencast] No PipeWire remote or streams";
+        closeSession();
+        return {};
+    }
+
+    // pw_context_connect_fd takes ownership of the descriptor.
+    std::vector<CapturedFrame> frames = capturePipeWireStreams(dup(remote.value().fileDescriptor()), streams);
+    closeSession();
+    return frames;
+}
+
+// ---- PipeWire ---------------------------------------------------------------
+
+namespace {
+
+struct StreamCapture
+{
+    pw_thread_loop *loop = nullptr;
+    pw_stream *stream = nullptr;
+    spa_hook listener{};
+    spa_video_info_raw format{};
+    bool negotiated = false;
+    bool done = false;
+    QImage image;
+    int *remaining = nullptr;
+};
+
+QImage::Format imageFormat(spa_video_format format)
+{
+    switch (format)
+    {
+    case SPA_VIDEO_FORMAT_BGRx:
+        return QImage::Format_RGB32;
+    case SPA_VIDEO_FORMAT_BGRA:
+        return QImage::Format_ARGB32_Premultiplied;
+    case SPA_VIDEO_FORMAT_RGBx:
+        return QImage::Format_RGBX8888;
+    case SPA_VIDEO_FORMAT_RGBA:
+        return QImage::Format_RGBA8888_Premultiplied;
+    default:
+        return QImage::Format_Invalid;
+    }
+}
+
+void onParamChanged(void *data, uint32_t id, const spa_pod *param)
+{
+    auto *capture = static_cast<StreamCapture *>(data);
+    if (!param || id != SPA_PARAM_Format)
+        return;
+    if (spa_format_video_raw_parse(param, &capture->format) < 0)
+        return;
+    capture->negotiated = true;
+
+    // Ask for CPU-mappable buffers: memfd first, plain memory otherwise.
+    uint8_t buffer[256];
+    spa_pod_builder builder = SPA_POD_BUILDER_INIT(buffer, sizeof(buffer));
+    const spa_pod *params[1];
+    params[0] = static_cast<const spa_pod *>(spa_pod_builder_add_object(
+        &builder, SPA_TYPE_OBJECT_ParamBuffers, SPA_PARAM_Buffers,
+        SPA_PARAM_BUFFERS_dataType, SPA_POD_Int((1 << SPA_DATA_MemFd) | (1 << SPA_DATA_MemPtr))));
+    pw_stream_update_params(capture->stream, params, 1);
+}
+
+void onProcess(void *data)
+{
+    auto *capture = static_cast<StreamCapture *>(data);
+    pw_buffer *buffer = pw_stream_dequeue_buffer(capture->stream);
+    if (!buffer)
+        return;
+
+    const spa_data &plane = buffer->buffer->datas[0];
+    const QImage::Format format = imageFormat(capture->format.format);
+    if (!capture->done && capture->negotiated && plane.data && plane.chunk->size > 0
+        && !(plane.chunk->flags & SPA_CHUNK_FLAG_CORRUPTED) && format != QImage::Format_Invalid)
+    {
+        const int width = int(capture->format.size.width);
+        const int height = int(capture->format.size.height);
+        const int stride = plane.chunk->stride > 0 ? plane.chunk->stride : width * 4;
+        const QImage view(static_cast<const uchar *>(plane.data) + plane.chunk->offset,
+                          width, height, stride, format);
+        capture->image = FramePool::instance().copy(view);
+        capture->done = true;
+        --*capture->remaining;
+        pw_thread_loop_signal(capture->loop, false);
+    }
+
+    pw_stream_queue_buffer(capture->stream, buffer);
+}
+
+const pw_stream_events kStreamEvents = []()
+{
+    pw_stream_events events{};
+    events.version = PW_VERSION_STREAM_EVENTS;
+    events.param_changed = onParamChanged;
+    events.process = onProcess;
+    return events;
+}();
+
+QScreen *matchScreen(const ScreencastStream &stream, size_t index, size_t count)
+{
+    const QList<QScreen *> screens = QGuiApplication::screens();
+    for (QScreen *screen : screens)
+    {
+        if (!stream.size.isEmpty() && screen->geometry() == QRect(stream.position, stream.size))
+            return screen;
+    }
+    return int(count) == screens.size() ? screens[int(index)] : nullptr;
+}
+
+} // namespace
+
+std::vector<CapturedFrame> capturePipeWireStreams(int fd, const std::vector<ScreencastStream> &streams)
+{
+    std::vector<CapturedFrame> frames;
+    if (streams.empty())
+    {
+        if (fd >= 0)
+            close(fd);
+        return frames;
+    }
+
+    pw_init(nullptr, nullptr);
+
+    pw_thread_loop *loop = pw_thread_loop_new("qt-capture-pw", nullptr);
+    pw_context *context = pw_context_new(pw_thread_loop_get_loop(loop), nullptr, 0);
+    pw_thread_loop_start(loop);
+    pw_thread_loop_lock(loop);
+
+    pw_core *core = fd >= 0 ? pw_context_connect_fd(context, fd, nullptr, 0)
+                            : pw_context_connect(context, nullptr, 0);
+    if (!core)
+    {
+        qWarning() << "[Screencast] Cannot connect to PipeWire";
+        pw_thread_loop_unlock(loop);
+        pw_thread_loop_stop(loop);
+        pw_context_destroy(context);
+        pw_thread_loop_destroy(loop);
+        return frames;
+    }
+
+    // Offer the packed 32-bit layouts QImage can wrap directly, any size.
+    spa_rectangle defaultSize{1920, 1080};
+    spa_rectangle minSize{1, 1};
+    spa_rectangle maxSize{16384, 16384};
+    spa_fraction defaultRate{0, 1};
+    spa_fraction minRate{0, 1};
+    spa_fraction maxRate{1000, 1};
+
+    int remaining = int(streams.size());
+    std::vector<std::unique_ptr<StreamCapture>> captures;
+    for (const ScreencastStream &stream : streams)
+    {
+        auto capture = std::make_unique<StreamCapture>();
+        capture->loop = loop;
+        capture->remaining = &remaining;
+        capture->stream = pw_stream_new(core, "qt-capture",
+                                        pw_properties_new(PW_KEY_MEDIA_TYPE, "Video",
+                                                          PW_KEY_MEDIA_CATEGORY, "Capture",
+                                                          PW_KEY_MEDIA_ROLE, "Screen", nullptr));
+        pw_stream_add_listener(capture->stream, &capture->listener, &kStreamEvents, capture.get());
+
+        uint8_t buffer[1024];
+        spa_pod_builder builder = SPA_POD_BUILDER_INIT(buffer, sizeof(buffer));
+        const spa_pod *params[1];
+        params[0] = static_cast<const spa_pod *>(spa_pod_builder_add_object(
+            &builder, SPA_TYPE_OBJECT_Format, SPA_PARAM_EnumFormat,
+            SPA_FORMAT_mediaType, SPA_POD_Id(SPA_MEDIA_TYPE_video),
+            SPA_FORMAT_mediaSubtype, SPA_POD_Id(SPA_MEDIA_SUBTYPE_raw),
+            SPA_FORMAT_VIDEO_format, SPA_POD_CHOICE_ENUM_Id(5, SPA_VIDEO_FORMAT_BGRx, SPA_VIDEO_FORMAT_BGRx,
+                                                            SPA_VIDEO_FORMAT_BGRA, SPA_VIDEO_FORMAT_RGBx,
+                                                            SPA_VIDEO_FORMAT_RGBA),
+            SPA_FORMAT_VIDEO_size, SPA_POD_CHOICE_RANGE_Rectangle(&defaultSize, &minSize, &maxSize),
+            SPA_FORMAT_VIDEO_framerate, SPA_POD_CHOICE_RANGE_Fraction(&defaultRate, &minRate, &maxRate)));
+
+        pw_stream_connect(capture->stream, PW_DIRECTION_INPUT, stream.nodeId,
+                          pw_stream_flags(PW_STREAM_FLAG_AUTOCONNECT | PW_STREAM_FLAG_MAP_BUFFERS),
+                          params, 1);
+        captures.push_back(std::move(capture));
+    }
+
+    while (remaining > 0)
+    {
+        if (pw_thread_loop_timed_wait(loop, kFrameTimeoutSec) != 0)
+        {
+            qWarning() << "[Screencast] Timed out waiting for frames," << remaining << "missing";
+            break;
+        }
+    }
+
+    for (auto &capture : captures)
+        pw_stream_destroy(capture->stream);
+    pw_core_disconnect(core);
+    pw_thread_loop_unlock(loop);
+    pw_thread_loop_stop(loop);
+    pw_context_destroy(context);
+    pw_thread_loop_destroy(loop);
+
+    if (remaining > 0)
+        return frames;
+
+    for (size_t i = 0; i < captures.size(); ++i)
+    {
+        const ScreencastStream &stream = streams[i];
+        CapturedFrame frame;
+        frame.image = captures[i]->image;
+        if (QScreen *screen = matchScreen(stream, i, streams.size()))
+        {
+            frame.geometry = screen->geometry();
+            frame.name = screen->name();
+        }
+        else
+        {
+            frame.geometry = QRect(stream.position, stream.size.isEmpty() ? frame.image.size() : stream.size);
+        }
+        frame.devicePixelRatio = frame.geometry.width() > 0
+            ? double(frame.image.width()) / double(frame.geometry.width())
+            : 1.0;
+        frame.image.setDevicePixelRatio(frame.devicePixelRatio);
+        frames.push_back(frame);
+    }
+
+    ScreenGrabber::sortLeftToRight(frames);
+    for (size_t i = 0; i < frames.size(); ++i)
+        frames[i].index = int(i);
+    return frames;
+}
+
+#include "PipeWireScreencast.moc"
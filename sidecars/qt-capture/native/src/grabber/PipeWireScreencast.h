@@ -0,0 +1,45 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef PIPEWIRESCREENCAST_H
+#define PIPEWIRESCREENCAST_H
+
+#include <QPoint>
+#include <QSize>
+#include <cstdint>
+#include <vector>
+
+#include "ScreenGrabber.h"
+
+/// One PipeWire video node handed out by the ScreenCast portal.
+struct ScreencastStream
+{
+    uint32_t nodeId = 0;
+    QPoint position; ///< logical, as reported by the portal (may be unset)
+    QSize size;
+};
+
+/**
+ * Grabs every monitor through the xdg-desktop-portal ScreenCast interface.
+ *
+ * The session is opened with persist_mode=2 and the restore token of the
+ * previous run, so only the very first capture shows the compositor's
+ * monitor picker. Each stream is sampled for exactly one frame and the
+ * session is closed again. Returns an empty vector if the portal is
+ * missing, the user declines, or no frame arrives in time.
+ */
+std::vector<CapturedFrame> captureScreencastPortal();
+
+/**
+ * Pulls a single frame from each PipeWire node. @p fd is a remote from
+ * OpenPipeWireRemote, or -1 to connect to the session's default daemon
+ * (handy for testing against a virtual video source).
+ */
+std::vector<CapturedFrame> capturePipeWireStreams(int fd, const std::vector<ScreencastStream> &streams);
+
+#endif // PIPEWIRESCREENCAST_H
@@ -0,0 +1,398 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "WlrScreencopy.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QScreen>
+#include <memory>
+#include <cstring>
+#include <poll.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <wayland-client.h>
+#include "wlr-screencopy-unstable-v1-client-protocol.h"
+
+namespace {
+
+constexpr int kTimeoutMs = 2000;
+constexpr uint32_t kManagerVersion = 3;
+constexpr uint32_t kOutputVersion = 4;
+
+struct Mapping
+{
+    void *data;
+    size_t bytes;
+};
+
+struct State;
+
+struct Output
+{
+    State *state = nullptr;
+    wl_output *output = nullptr;
+    QString name;
+    QPoint position;
+    QSize mode;
+    int scale = 1;
+
+    zwlr_screencopy_frame_v1 *frame = nullptr;
+    uint32_t format = 0;
+    QSize size;
+    uint32_t stride = 0;
+    bool offeredShm = false;
+    uint32_t flags = 0;
+    bool copying = false;
+    bool done = false;
+    bool failed = false;
+
+    wl_buffer *buffer = nullptr;
+    Mapping *mapping = nullptr;
+};
+
+struct State
+{
+    wl_shm *shm = nullptr;
+    zwlr_screencopy_manager_v1 *manager = nullptr;
+    uint32_t managerVersion = 0;
+    std::vector<std::unique_ptr<Output>> outputs;
+};
+
+void unmap(void *info)
+{
+    auto *mapping = static_cast<Mapping *>(info);
+    munmap(mapping->data, mapping->bytes);
+    delete mapping;
+}
+
+QImage::Format imageFormat(uint32_t shmFormat)
+{
+    // wl_shm formats are little-endian packed; XRGB8888 is BGRA in memory.
+    switch (shmFormat)
+    {
+    case WL_SHM_FORMAT_XRGB8888:
+        return QImage::Format_RGB32;
+    case WL_SHM_FORMAT_ARGB8888:
+        return QImage::Format_ARGB32_Premultiplied;
+    case WL_SHM_FORMAT_XBGR8888:
+        return QImage::Format_RGBX8888;
+    case WL_SHM_FORMAT_ABGR8888:
+        return QImage::Format_RGBA8888_Premultiplied;
+    default:
+        return QImage::Format_Invalid;
+    }
+}
+
+// ---- wl_output ------------------------------------------------------------
+
+void outputGeometry(void *data, wl_output *, int32_t x, int32_t y, int32_t, int32_t,
+                    int32_t, const char *, const char *, int32_t)
+{
+    static_cast<Output *>(data)->position = QPoint(x, y);
+}
+
+void outputMode(void *data, wl_output *, uint32_t flags, int32_t width, int32_t height, int32_t)
+{
+    if (flags & WL_OUTPUT_MODE_CURRENT)
+        static_cast<Output *>(data)->mode = QSize(width, height);
+}
+
+void outputDone(void *, wl_output *) {}
+
+void outputScale(void *data, wl_output *, int32_t factor)
+{
+    static_cast<Output *>(data)->scale = qMax(1, factor);
+}
+
+void outputName(void *data, wl_output *, const char *name)
+{
+    static_cast<Output *>(data)->name = QString::fromUtf8(name);
+}
+
+void outputDescription(void *, wl_output *, const char *) {}
+
+const wl_output_listener kOutputListener = {
+    outputGeometry,
+    outputMode,
+    outputDone,
+    outputScale,
+    outputName,
+    outputDescription,
+};
+
+// ---- registry -------------------------------------------------------------
+
+void registryGlobal(void *data, wl_registry *registry, uint32_t name, const char *interface, uint32_t version)
+{
+    auto *state = static_cast<State *>(data);
+
+    if (std::strcmp(interface, wl_shm_interface.name) == 0)
+    {
+        state->shm = static_cast<wl_shm *>(wl_registry_bind(registry, name, &wl_shm_interface, 1));
+    }
+    else if (std::strcmp(interface, zwlr_screencopy_manager_v1_interface.name) == 0)
+    {
+        state->managerVersion = qMin(version, kManagerVersion);
+        state->manager = static_cast<zwlr_screencopy_manager_v1 *>(
+            wl_registry_bind(registry, name, &zwlr_screencopy_manager_v1_interface, state->managerVersion));
+    }
+    else if (std::strcmp(interface, wl_output_interface.name) == 0)
+    {
+        auto output = std::make_unique<Output>();
+        output->state = state;
+        output->output = static_cast<wl_output *>(
+            wl_registry_bind(registry, name, &wl_output_interface, qMin(version, kOutputVersion)));
+        wl_output_add_listener(output->output, &kOutputListener, output.get());
+        state->outputs.push_back(std::move(output));
+    }
+}
+
+void registryGlobalRemove(void *, wl_registry *, uint32_t) {}
+
+const wl_registry_listener kRegistryListener = {
+    registryGlobal,
+    registryGlobalRemove,
+};
+
+// ---- screencopy frame -----------------------------------------------------
+
+void startCopy(Output *out)
+{
+    if (out->copying || !out->offeredShm)
+        return;
+    out->copying = true;
+
+    const size_t bytes = size_t(out->stride) * size_t(out->size.height());
+    const int fd = memfd_create("qt-capture-screencopy", MFD_CLOEXEC);
+    if (fd < 0 || ftruncate(fd, off_t(bytes)) != 0)
+    {
+        if (fd >= 0)
+            close(fd);
+        out->failed = true;
+        return;
+    }
+
+    void *data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        close(fd);
+        out->failed = true;
+        return;
+    }
+
+    wl_shm_pool *pool = wl_shm_create_pool(out->state->shm, fd, int32_t(bytes));
+    out->buffer = wl_shm_pool_create_buffer(pool, 0, out->size.width(), out->size.height(),
+                                            int32_t(out->stride), out->format);
+    wl_shm_pool_destroy(pool);
+    close(fd);
+
+    out->mapping = new Mapping{data, bytes};
+    zwlr_screencopy_frame_v1_copy(out->frame, out->buffer);
+}
+
+void frameBuffer(void *data, zwlr_screencopy_frame_v1 *, uint32_t format, uint32_t width, uint32_t height, uint32_t stride)
+{
+    auto *out = static_cast<Output *>(data);
+    if (imageFormat(format) == QImage::Format_Invalid || out->offeredShm)
+        return;
+
+    out->format = format;
+    out->size = QSize(int(width), int(height));
+    out->stride = stride;
+    out->offeredShm = true;
+
+    // Before v3 there is no buffer_done: the first shm offer is final.
+    if (out->state->managerVersion < 3)
+        startCopy(out);
+}
+
+void frameFlags(void *data, zwlr_screencopy_frame_v1 *, uint32_t flags)
+{
+    static_cast<Output *>(data)->flags = flags;
+}
+
+void frameReady(void *data, zwlr_screencopy_frame_v1 *, uint32_t, uint32_t, uint32_t)
+{
+    static_cast<Output *>(data)->done = true;
+}
+
+void frameFailed(void *data, zwlr_screencopy_frame_v1 *)
+{
+    auto *out = static_cast<Output *>(data);
+    out->failed = true;
+    out->done = true;
+}
+
+void frameDamage(void *, zwlr_screencopy_frame_v1 *, uint32_t, uint32_t, uint32_t, uint32_t) {}
+
+void frameDmabuf(void *, zwlr_screencopy_frame_v1 *, uint32_t, uint32_t, uint32_t) {}
+
+void frameBufferDone(void *data, zwlr_screencopy_frame_v1 *)
+{
+    auto *out = static_cast<Output *>(data);
+    if (!out->offeredShm)
+    {
+        out->failed = true;
+        out->done = true;
+        return;
+    }
+    startCopy(out);
+}
+
+const zwlr_screencopy_frame_v1_listener kFrameListener = {
+    frameBuffer,
+    frameFlags,
+    frameReady,
+    frameFailed,
+    frameDamage,
+    frameDmabuf,
+    frameBufferDone,
+};
+
+bool allDone(const State &state)
+{
+    for (const auto &out : state.outputs)
+    {
+        if (!out->done && !out->failed)
+            return false;
+    }
+    return true;
+}
+
+/// Dispatches until every frame settled or the deadline passed.
+bool dispatchUntilDone(wl_display *display, const State &state)
+{
+    QElapsedTimer clock;
+    clock.start();
+    const int fd = wl_display_get_fd(display);
+
+    while (!allDone(state))
+    {
+        while (wl_display_prepare_read(display) != 0)
+            wl_display_dispatch_pending(display);
+        wl_display_flush(display);
+
+        const int remaining = kTimeoutMs - int(clock.elapsed());
+        pollfd pfd{fd, POLLIN, 0};
+        if (remaining <= 0 || poll(&pfd, 1, remaining) <= 0)
+        {
+            wl_display_cancel_read(display);
+            return false;
+        }
+        if (wl_display_read_events(display) != 0 || wl_display_dispatch_pending(display) < 0)
+            return false;
+    }
+    return true;
+}
+
+QScreen *matchScreen(const Output &out, int index, int outputCount)
+{
+    const QList<QScreen *> screens = QGuiApplication::screens();
+    for (QScreen *screen : screens)
+    {
+        if (!out.name.isEmpty() && screen->name() == out.name)
+            return screen;
+    }
+    return index < screens.size() && screens.size() == outputCount ? screens[index] : nullptr;
+}
+
+} // namespace
+
+std::vector<CapturedFrame> captureWlrScreencopy()
+{
+    std::vector<CapturedFrame> frames;
+
+    wl_display *display = wl_display_connect(nullptr);
+    if (!display)
+        return frames;
+
+    State state;
+
+    wl_registry *registry = wl_display_get_registry(display);
+    wl_registry_add_listener(registry, &kRegistryListener, &state);
+    wl_display_roundtrip(display); // globals
+    wl_display_roundtrip(display); // wl_output properties
+
+    if (!state.manager || !state.shm || state.outputs.empty())
+    {
+        qDebug() << "[WlrScreencopy] Compositor does not offer zwlr_screencopy_manager_v1";
+    }
+    else
+    {
+        // Request every output up front; the compositor fills them in one
+        // pass instead of one round trip per screen.
+        for (auto &out : state.outputs)
+        {
+            out->frame = zwlr_screencopy_manager_v1_capture_output(state.manager, 0, out->output);
+            zwlr_screencopy_frame_v1_add_listener(out->frame, &kFrameListener, out.get());
+        }
+
+        if (!dispatchUntilDone(display, state))
+            qWarning() << "[WlrScreencopy] Timed out waiting for frames";
+
+        for (size_t i = 0; i < state.outputs.size(); ++i)
+        {
+            Output &out = *state.outputs[i];
+            if (!out.done || out.failed || !out.mapping)
+            {
+                qWarning() << "[WlrScreencopy] Copy failed for output" << out.name;
+                frames.clear();
+                break;
+            }
+
+            QImage image(static_cast<uchar *>(out.mapping->data), out.size.width(), out.size.height(),
+                         int(out.stride), imageFormat(out.format), unmap, out.mapping);
+            out.mapping = nullptr;
+            if (out.flags & ZWLR_SCREENCOPY_FRAME_V1_FLAGS_Y_INVERT)
+                image = image.mirrored(false, true);
+
+            CapturedFrame frame;
+            if (QScreen *screen = matchScreen(out, int(i), int(state.outputs.size())))
+            {
+                frame.geometry = screen->geometry();
+                frame.name = screen->name();
+                frame.devicePixelRatio = frame.geometry.width() > 0
+                    ? double(image.width()) / double(frame.geometry.width())
+                    : 1.0;
+            }
+            else
+            {
+                frame.geometry = QRect(out.position, out.mode / out.scale);
+                frame.name = out.name;
+                frame.devicePixelRatio = out.scale;
+            }
+            frame.image = image;
+            frame.image.setDevicePixelRatio(frame.devicePixelRatio);
+            frames.push_back(frame);
+        }
+    }
+
+    for (auto &out : state.outputs)
+    {
+        if (out->mapping)
+            unmap(out->mapping);
+        if (out->buffer)
+            wl_buffer_destroy(out->buffer);
+        if (out->frame)
+            zwlr_screencopy_frame_v1_destroy(out->frame);
+        if (wl_output_get_version(out->output) >= WL_OUTPUT_RELEASE_SINCE_VERSION)
+            wl_output_release(out->output);
+        else
+            wl_output_destroy(out->output);
+    }
+    if (state.manager)
+        zwlr_screencopy_manager_v1_destroy(state.manager);
+    if (state.shm)
+        wl_shm_destroy(state.shm);
+    wl_registry_destroy(registry);
+    wl_display_disconnect(display);
+
+    ScreenGrabber::sortLeftToRight(frames);
+    for (size_t i = 0; i < frames.size(); ++i)
+        frames[i].index = int(i);
+    return frames;
+}
@@ -0,0 +1,29 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef WLRSCREENCOPY_H
+#define WLRSCREENCOPY_H
+
+#include <vector>
+
+#include "ScreenGrabber.h"
+
+/**
+ * Grabs every output through zwlr_screencopy_manager_v1 (sway, Hyprland,
+ * river, ...). Copies for all outputs are requested at once and land in
+ * per-output wl_shm buffers at each output's own scale; the resulting
+ * images wrap those mappings without a further copy.
+ *
+ * Connects to $WAYLAND_DISPLAY independently of Qt's platform plugin, so
+ * it works while Qt itself runs on XWayland. Returns an empty vector when
+ * the compositor lacks the protocol or a copy fails, leaving the caller
+ * to fall back to the Screenshot portal.
+ */
+std::vector<CapturedFrame> captureWlrScreencopy();
+
+#endif // WLRSCREENCOPY_H
@@ -0,0 +1,174 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "X11WindowCapture.h"
+#include "XcbShmImage.h"
+#include "FramePool.h"
+#include <QAbstractNativeEventFilter>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QEventLoop>
+#include <QTimer>
+#include <cstdlib>
+#include <xcb/composite.h>
+#include <xcb/damage.h>
+
+namespace
+{
+// Upper bound on the wait for a freshly redirected client to repaint
+// occluded areas into its new backing pixmap.
+constexpr int kRepaintTimeoutMs = 100;
+// The repaint counts as done once the window has been quiet this long.
+constexpr int kRepaintQuietMs = 16;
+
+/**
+ * Waits for a window's repaint to settle by watching XDamage on it, in a
+ * local event loop so the GUI thread keeps dispatching. Damage events come
+ * in through Qt's xcb event reader; without XDamage, or when they never
+ * arrive, the wait ends at kRepaintTimeoutMs.
+ */
+class RepaintWaiter : public QAbstractNativeEventFilter
+{
+public:
+    RepaintWaiter(xcb_connection_t *conn, xcb_window_t window)
+        : m_conn(conn)
+    {
+        const xcb_query_extension_reply_t *ext = xcb_get_extension_data(m_conn, &xcb_damage_id);
+        xcb_damage_query_version_reply_t *version = ext && ext->present
+            ? xcb_damage_query_version_reply(m_conn, xcb_damage_query_version(m_conn, 1, 1), nullptr)
+            : nullptr;
+        if (version)
+        {
+            // Created before the redirect so the repaint it triggers is seen.
+            m_damageEvent = ext->first_event + XCB_DAMAGE_NOTIFY;
+            m_damage = xcb_generate_id(m_conn);
+            xcb_damage_create(m_conn, m_damage, window, XCB_DAMAGE_REPORT_LEVEL_NON_EMPTY);
+            QCoreApplication::instance()->installNativeEventFilter(this);
+        }
+        free(version);
+
+        m_quiet.setSingleShot(true);
+        m_quiet.setInterval(kRepaintQuietMs);
+        m_timeout.setSingleShot(true);
+        m_timeout.setInterval(kRepaintTimeoutMs);
+        QObject::connect(&m_quiet, &QTimer::timeout, &m_loop, &QEventLoop::quit);
+        QObject::connect(&m_timeout, &QTimer::timeout, &m_loop, &QEventLoop::quit);
+    }
+
+    ~RepaintWaiter() override
+    {
+        if (m_damage)
+        {
+            QCoreApplication::instance()->removeNativeEventFilter(this);
+            xcb_damage_destroy(m_conn, m_damage);
+        }
+    }
+
+    void wait()
+    {
+        xcb_flush(m_conn);
+        m_timeout.start();
+        m_loop.exec(QEventLoop::ExcludeUserInputEvents);
+    }
+
+    bool nativeEventFilter(const QByteArray &eventType, void *message, qintptr *result) override
+    {
+        Q_UNUSED(result);
+        if (eventType != "xcb_generic_event_t")
+            return false;
+
+        auto *event = static_cast<xcb_generic_event_t *>(message);
+        if ((event->response_type & ~0x80) != m_damageEvent)
+            return false;
+
+        auto *notify = reinterpret_cast<xcb_damage_notify_event_t *>(event);
+        if (notify->damage != m_damage)
+            return false;
+
+        // Re-arm for the next paint and restart the quiet period.
+        xcb_damage_subtract(m_conn, m_damage, XCB_NONE, XCB_NONE);
+        xcb_flush(m_conn);
+        m_quiet.start();
+        return true;
+    }
+
+private:
+    xcb_connection_t *m_conn;
+    xcb_damage_damage_t m_damage = 0;
+    uint8_t m_damageEvent = 0;
+    QEventLoop m_loop;
+    QTimer m_quiet;
+    QTimer m_timeout;
+};
+} // namespace
+
+QImage captureX11Window(xcb_connection_t *conn, xcb_window_t window, QRect *nativeGeometry)
+{
+    xcb_composite_query_version_reply_t *version = xcb_composite_query_version_reply(
+        conn, xcb_composite_query_version(conn, 0, 2), nullptr);
+    if (!version)
+    {
+        qWarning() << "[X11WindowCapture] XComposite extension not available";
+        return QImage();
+    }
+    free(version);
+
+    xcb_get_geometry_reply_t *geo = xcb_get_geometry_reply(conn, xcb_get_geometry(conn, window), nullptr);
+    if (!geo)
+    {
+        qWarning() << "[X11WindowCapture] No such window:" << Qt::hex << window;
+        return QImage();
+    }
+
+    const int border = geo->border_width;
+    const QSize size(geo->width + 2 * border, geo->height + 2 * border);
+    const xcb_window_t root = geo->root;
+    free(geo);
+
+    xcb_translate_coordinates_reply_t *pos = xcb_translate_coordinates_reply(
+        conn, xcb_translate_coordinates(conn, window, root, 0, 0), nullptr);
+    if (nativeGeometry)
+    {
+        const QPoint topLeft = pos ? QPoint(pos->dst_x - border, pos->dst_y - border) : QPoint();
+        *nativeGeometry = QRect(topLeft, size);
+    }
+    free(pos);
+
+    // A running compositor already redirects every window manually, which
+    // makes our request fail with BadAccess; its pixmaps are current then.
+    // Otherwise the client repaints what was covered into the new pixmap.
+    RepaintWaiter repaint(conn, window);
+    xcb_generic_error_t *error = xcb_request_check(
+        conn, xcb_composite_redirect_window_checked(conn, window, XCB_COMPOSITE_REDIRECT_AUTOMATIC));
+    const bool redirectedHere = error == nullptr;
+    free(error);
+
+    if (redirectedHere)
+        repaint.wait();
+
+    xcb_pixmap_t pixmap = xcb_generate_id(conn);
+    error = xcb_request_check(conn, xcb_composite_name_window_pixmap_checked(conn, window, pixmap));
+
+    QImage image;
+    if (error)
+    {
+        qWarning() << "[X11WindowCapture] NameWindowPixmap failed, error" << error->error_code;
+        free(error);
+    }
+    else
+    {
+        XcbShmImage shm(conn);
+        QImage grabbed = shm.grab(pixmap, QRect(QPoint(0, 0), size));
+        image = FramePool::instance().copy(grabbed);
+        xcb_free_pixmap(conn, pixmap);
+    }
+
+    if (redirectedHere)
+        xcb_composite_unredirect_window(conn, window, XCB_COMPOSITE_REDIRECT_AUTOMATIC);
+    xcb_flush(conn);
+
+    return image;
+}
@@ -0,0 +1,27 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef X11WINDOWCAPTURE_H
+#define X11WINDOWCAPTURE_H
+
+#include <QImage>
+#include <QRect>
+#include <xcb/xcb.h>
+
+/**
+ * Captures a single window from its XComposite backing pixmap, so windows,
+ * menus or tooltips stacked above it do not show up in the result. Without
+ * a compositor the window is redirected for the grab, and a local event
+ * loop waits for its repaint to settle, up to 100 ms.
+ *
+ * @param nativeGeometry Receives the window's outer rect in root coordinates.
+ * @return Owned image of the window, or a null image on failure.
+ */
+QImage captureX11Window(xcb_connection_t *conn, xcb_window_t window, QRect *nativeGeometry);
+
+#endif // X11WINDOWCAPTURE_H
@@ -0,0 +1,109 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "X11WindowTree.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+struct TreeNode
+{
+    xcb_window_t window;
+    QRect geometry;   // outer rect in root coordinates, clipped to parent
+    QPoint origin;    // inner origin children are positioned against
+    std::vector<int> path;
+    size_t parent = 0; // index into the previous level
+};
+}
+
+std::vector<QRect> queryX11WindowTree(xcb_connection_t *conn, xcb_window_t root, int maxDepth)
+{
+    std::vector<TreeNode> nodes;
+    std::vector<TreeNode> level;
+    level.push_back({root, QRect(), QPoint(0, 0), {}, 0});
+
+    for (int depth = 0; depth < maxDepth && !level.empty(); ++depth)
+    {
+        std::vector<xcb_query_tree_cookie_t> treeCookies;
+        treeCookies.reserve(level.size());
+        for (const TreeNode &parent : level)
+            treeCookies.push_back(xcb_query_tree(conn, parent.window));
+
+        std::vector<TreeNode> children;
+        for (size_t p = 0; p < level.size(); ++p)
+        {
+            xcb_query_tree_reply_t *tree = xcb_query_tree_reply(conn, treeCookies[p], nullptr);
+            if (!tree)
+                continue;
+
+            const xcb_window_t *ids = xcb_query_tree_children(tree);
+            const int count = xcb_query_tree_children_length(tree);
+            for (int i = 0; i < count; ++i)
+            {
+                TreeNode child{ids[i], QRect(), QPoint(), level[p].path, p};
+                child.path.push_back(i);
+                children.push_back(std::move(child));
+            }
+            free(tree);
+        }
+
+        std::vector<xcb_get_window_attributes_cookie_t> attrCookies;
+        std::vector<xcb_get_geometry_cookie_t> geoCookies;
+        attrCookies.reserve(children.size());
+        geoCookies.reserve(children.size());
+        for (const TreeNode &child : children)
+        {
+            attrCookies.push_back(xcb_get_window_attributes(conn, child.window));
+            geoCookies.push_back(xcb_get_geometry(conn, child.window));
+        }
+
+        std::vector<TreeNode> next;
+        for (size_t i = 0; i < children.size(); ++i)
+        {
+            xcb_get_window_attributes_reply_t *attr = xcb_get_window_attributes_reply(conn, attrCookies[i], nullptr);
+            xcb_get_geometry_reply_t *geo = xcb_get_geometry_reply(conn, geoCookies[i], nullptr);
+
+            const bool viewable = attr && geo
+                && attr->map_state == XCB_MAP_STATE_VIEWABLE
+                && attr->_class == XCB_WINDOW_CLASS_INPUT_OUTPUT;
+
+            if (viewable)
+            {
+                const TreeNode &parent = level[children[i].parent];
+                TreeNode &child = children[i];
+
+                const int border = geo->border_width;
+                const QPoint topLeft = parent.origin + QPoint(geo->x, geo->y);
+                child.geometry = QRect(topLeft, QSize(geo->width + 2 * border, geo->height + 2 * border));
+                if (parent.geometry.isValid())
+                    child.geometry = child.geometry.intersected(parent.geometry);
+                child.origin = topLeft + QPoint(border, border);
+
+                if (!child.geometry.isEmpty())
+                {
+                    nodes.push_back(child);
+                    next.push_back(child);
+                }
+            }
+
+            free(attr);
+            free(geo);
+        }
+
+        level = std::move(next);
+    }
+
+    // Pre-order by stacking path: every subtree sits above lower siblings.
+    std::sort(nodes.begin(), nodes.end(), [](const TreeNode &a, const TreeNode &b)
+              { return a.path < b.path; });
+
+    std::vector<QRect> rects;
+    rects.reserve(nodes.size());
+    for (const TreeNode &node : nodes)
+        rects.push_back(node.geometry);
+    return rects;
+}
@@ -0,0 +1,27 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef X11WINDOWTREE_H
+#define X11WINDOWTREE_H
+
+#include <vector>
+#include <QRect>
+#include <xcb/xcb.h>
+
+/**
+ * Walks the X11 window tree below @p root down to @p maxDepth levels and
+ * returns the geometry of every viewable window in root coordinates,
+ * ordered bottom-to-top (parents before their children).
+ *
+ * Requests for one whole level are sent before any reply is read, so the
+ * walk costs one round trip per request type and level instead of one per
+ * window.
+ */
+std::vector<QRect> queryX11WindowTree(xcb_connection_t *conn, xcb_window_t root, int maxDepth = 2);
+
+#endif // X11WINDOWTREE_H
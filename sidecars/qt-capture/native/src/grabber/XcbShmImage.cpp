@@ -0,0 +1,178 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "XcbShmImage.h"
+#include <QDebug>
+#include <cstdlib>
+#include <cstring>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+XcbShmImage::XcbShmImage(xcb_connection_t *conn, bool useShm)
+    : m_conn(conn)
+{
+    if (!useShm)
+        return;
+
+    xcb_shm_query_version_reply_t *version =
+        xcb_shm_query_version_reply(m_conn, xcb_shm_query_version(m_conn), nullptr);
+    m_shmAvailable = version != nullptr;
+    free(version);
+
+    if (!m_shmAvailable)
+        qDebug() << "[XcbShmImage] MIT-SHM unavailable, using GetImage";
+}
+
+XcbShmImage::~XcbShmImage()
+{
+    release();
+}
+
+void XcbShmImage::release()
+{
+    if (m_seg)
+    {
+        xcb_shm_detach(m_conn, m_seg);
+        xcb_flush(m_conn);
+        m_seg = 0;
+    }
+    if (m_data)
+    {
+        shmdt(m_data);
+        m_data = nullptr;
+    }
+    m_shmId = -1;
+    m_capacity = 0;
+}
+
+bool XcbShmImage::ensureCapacity(size_t bytes)
+{
+    if (m_data && bytes <= m_capacity)
+        return true;
+
+    release();
+
+    m_shmId = shmget(IPC_PRIVATE, bytes, IPC_CREAT | 0600);
+    if (m_shmId < 0)
+        return false;
+
+    void *addr = shmat(m_shmId, nullptr, 0);
+    if (addr == reinterpret_cast<void *>(-1))
+    {
+        shmctl(m_shmId, IPC_RMID, nullptr);
+        m_shmId = -1;
+        return false;
+    }
+    m_data = static_cast<uchar *>(addr);
+
+    m_seg = xcb_generate_id(m_conn);
+    xcb_generic_error_t *error =
+        xcb_request_check(m_conn, xcb_shm_attach_checked(m_conn, m_seg, m_shmId, 0));
+
+    // Mark for removal now; the segment lives until both sides detach.
+    shmctl(m_shmId, IPC_RMID, nullptr);
+
+    if (error)
+    {
+        free(error);
+        m_seg = 0;
+        release();
+        return false;
+    }
+
+    m_capacity = bytes;
+    return true;
+}
+
+QImage::Format XcbShmImage::formatFor(uint8_t depth, int bitsPerPixel)
+{
+    // Z-pixmap at 24/32 bpp is BGRA in memory on little-endian servers,
+    // which is QImage's native 32-bit layout.
+    switch (bitsPerPixel)
+    {
+    case 32:
+        return depth == 32 ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32;
+    case 24:
+        return QImage::Format_BGR888;
+    case 16:
+        return depth == 15 ? QImage::Format_RGB555 : QImage::Format_RGB16;
+    default:
+        return QImage::Format_Invalid;
+    }
+}
+
+QImage XcbShmImage::wrap(const uchar *data, const QSize &size, uint8_t depth, size_t bytes) const
+{
+    int bitsPerPixel = 0;
+    for (auto it = xcb_setup_pixmap_formats_iterator(xcb_get_setup(m_conn)); it.rem; xcb_format_next(&it))
+    {
+        if (it.data->depth == depth)
+            bitsPerPixel = it.data->bits_per_pixel;
+    }
+
+    // Scanlines are padded to the server's scanline_pad, so the stride is
+    // whatever the reply holds per row, not width times the pixel size.
+    const size_t stride = bytes / size_t(size.height());
+    const QImage::Format format = formatFor(depth, bitsPerPixel);
+    if (format == QImage::Format_Invalid || stride * 8 < size_t(size.width()) * bitsPerPixel)
+    {
+        qWarning() << "[XcbShmImage] Unsupported image: depth" << depth << "at" << bitsPerPixel
+                   << "bpp," << bytes << "bytes for" << size;
+        return QImage();
+    }
+    return QImage(data, size.width(), size.height(), qsizetype(stride), format);
+}
+
+QImage XcbShmImage::grab(xcb_drawable_t drawable, const QRect &rect)
+{
+    if (rect.isEmpty())
+        return QImage();
+
+    // Pixels are at most 32 bits and scanline_pad at most 32, so rows of
+    // width * 4 bytes always hold a padded scanline.
+    const size_t bytes = size_t(rect.width()) * rect.height() * 4;
+    if (!m_shmAvailable || !ensureCapacity(bytes))
+        return grabPlain(drawable, rect);
+
+    xcb_shm_get_image_reply_t *reply = xcb_shm_get_image_reply(
+        m_conn,
+        xcb_shm_get_image(m_conn, drawable,
+                          int16_t(rect.x()), int16_t(rect.y()),
+                          uint16_t(rect.width()), uint16_t(rect.height()),
+                          ~0u, XCB_IMAGE_FORMAT_Z_PIXMAP, m_seg, 0),
+        nullptr);
+
+    if (!reply)
+        return QImage();
+
+    const QImage image = wrap(m_data, rect.size(), reply->depth, reply->size);
+    free(reply);
+
+    if (image.isNull() || image.depth() == 32)
+        return image;
+    return image.convertToFormat(QImage::Format_RGB32);
+}
+
+QImage XcbShmImage::grabPlain(xcb_drawable_t drawable, const QRect &rect)
+{
+    xcb_get_image_reply_t *reply = xcb_get_image_reply(
+        m_conn,
+        xcb_get_image(m_conn, XCB_IMAGE_FORMAT_Z_PIXMAP, drawable,
+                      int16_t(rect.x()), int16_t(rect.y()),
+                      uint16_t(rect.width()), uint16_t(rect.height()), ~0u),
+        nullptr);
+
+    if (!reply)
+        return QImage();
+
+    const QImage view = wrap(xcb_get_image_data(reply), rect.size(), reply->depth,
+                             size_t(xcb_get_image_data_length(reply)));
+    QImage image;
+    if (!view.isNull())
+        image = view.depth() == 32 ? view.copy() : view.convertToFormat(QImage::Format_RGB32);
+    free(reply);
+    return image;
+}
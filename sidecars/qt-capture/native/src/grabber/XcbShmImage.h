@@ -0,0 +1,59 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef XCBSHMIMAGE_H
+#define XCBSHMIMAGE_H
+
+#include <QImage>
+#include <QRect>
+#include <xcb/xcb.h>
+#include <xcb/shm.h>
+
+/**
+ * @brief Reads X11 drawables through a reusable MIT-SHM segment.
+ *
+ * The segment is attached once and grown on demand, so repeated grabs skip
+ * both the socket copy of a plain GetImage and a fresh allocation. When the
+ * server lacks MIT-SHM (remote displays), or @p useShm is false, grabs use
+ * GetImage. Rows are read with the stride the server used; 15/16 and 24
+ * bits per pixel are converted to RGB32.
+ */
+class XcbShmImage
+{
+public:
+    explicit XcbShmImage(xcb_connection_t *conn, bool useShm = true);
+    ~XcbShmImage();
+
+    XcbShmImage(const XcbShmImage &) = delete;
+    XcbShmImage &operator=(const XcbShmImage &) = delete;
+
+    bool hasShm() const { return m_shmAvailable; }
+
+    /**
+     * Grabs @p rect of @p drawable. With MIT-SHM the returned image aliases
+     * the shared segment and is only valid until the next grab; copy it to
+     * keep it. Returns a null image on failure.
+     */
+    QImage grab(xcb_drawable_t drawable, const QRect &rect);
+
+private:
+    bool ensureCapacity(size_t bytes);
+    void release();
+    QImage grabPlain(xcb_drawable_t drawable, const QRect &rect);
+    QImage wrap(const uchar *data, const QSize &size, uint8_t depth, size_t bytes) const;
+    static QImage::Format formatFor(uint8_t depth, int bitsPerPixel);
+
+    xcb_connection_t *m_conn;
+    bool m_shmAvailable = false;
+    xcb_shm_seg_t m_seg = 0;
+    int m_shmId = -1;
+    uchar *m_data = nullptr;
+    size_t m_capacity = 0;
+};
+
+#endif // XCBSHMIMAGE_H
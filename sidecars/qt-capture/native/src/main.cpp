@@ -12,12 +12,36 @@
 #include <QCommandLineParser>
 #include <QDebug>
 #include <QScreen>
+#include <QElapsedTimer>
+#include <QScopeGuard>
+#include <QTimer>
+#include <QJsonDocument>
+#include <cstdio>
+#include <iostream>
 #include <vector>
+#include <memory>
 
 #include "config.h"
 #include "core/CaptureMode.h"
 #include "core/ScreenGrabber.h"
+#include "core/WindowIndex.h"
+#include "core/SessionFile.h"
+#include "core/CaptureHistory.h"
+#include "core/CaptureTuning.h"
+#include "core/JobPool.h"
+#include "core/FramePool.h"
+#include "core/LatencyProfile.h"
 #include "controller/CaptureController.h"
+#include "controller/OcrClient.h"
+#include "controller/CodeScanner.h"
+#include "controller/LifecycleEvents.h"
+#include "controller/QualityGovernor.h"
+#include "modes/ScrollCapture.h"
+#include "modes/RegionRecorder.h"
+#include "modes/TrainingWorkload.h"
+#ifdef Q_OS_LINUX
+#include "modes/RegionWatcher.h"
+#endif
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -56,6 +80,25 @@ static void applyPlatformWindowHacks(QQuickWindow *window)
 #endif
 }
 
+static bool parseRegion(const QString &text, QRect *region)
+{
+    const QStringList parts = text.split(',');
+    if (parts.size() != 4)
+        return false;
+
+    int values[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        bool ok = false;
+        values[i] = parts[i].trimmed().toInt(&ok);
+        if (!ok)
+            return false;
+    }
+
+    *region = QRect(values[0], values[1], values[2], values[3]);
+    return !region->isEmpty();
+}
+
 int main(int argc, char *argv[])
 {
 
@@ -104,7 +147,9 @@ int main(int argc, char *argv[])
 #endif
 
 #ifdef Q_OS_LINUX
-    qputenv("QT_QPA_PLATFORM", "xcb");
+    // Headless runs (PGO training) keep the offscreen platform.
+    if (qgetenv("QT_QPA_PLATFORM") != "offscreen")
+        qputenv("QT_QPA_PLATFORM", "xcb");
 #endif
 
     QGuiApplication app(argc, argv);
@@ -129,10 +174,131 @@ int main(int argc, char *argv[])
         "Use rectangle selection mode");
     parser.addOption(rectangleOption);
 
+    QCommandLineOption windowOption(
+        QStringList() << "w" << "window",
+        "Capture a single X11 window by id, ignoring anything covering it",
+        "id");
+    parser.addOption(windowOption);
+
+    QCommandLineOption watchOption(
+        "watch",
+        "Continuously capture a desktop region (X11), emitting a frame whenever its pixels change",
+        "x,y,w,h");
+    parser.addOption(watchOption);
+
+    QCommandLineOption scrollOption(
+        "scroll",
+        "Scrolling capture: select a region, then scroll its content to stitch one tall image");
+    parser.addOption(scrollOption);
+
+    QCommandLineOption recordOption(
+        "record",
+        "Record the selected region to an animated PNG for the given number of seconds",
+        "seconds");
+    parser.addOption(recordOption);
+
+    QCommandLineOption fpsOption(
+        "fps",
+        "Target frame rate for --record (default 15)",
+        "fps", "15");
+    parser.addOption(fpsOption);
+
+    QCommandLineOption dumpSessionOption(
+        "dump-session",
+        "Write the raw captured frames and metadata to a session file",
+        "path");
+    parser.addOption(dumpSessionOption);
+
+    QCommandLineOption loadSessionOption(
+        "load-session",
+        "Replay a session file instead of grabbing the screen",
+        "path");
+    parser.addOption(loadSessionOption);
+
+    QCommandLineOption reopenOption(
+        "reopen",
+        "Re-open the N-th most recent capture from history (1 = last) instead of grabbing the screen",
+        "n");
+    parser.addOption(reopenOption);
+
+    QCommandLineOption historyOption(
+        "history",
+        "Store this session's full-screen frames in the capture history for --reopen (off by default)");
+    parser.addOption(historyOption);
+
+    QCommandLineOption calibrateOption(
+        "calibrate",
+        "Time the available grab backends and encoder thread counts, cache the fastest for this display setup and exit");
+    parser.addOption(calibrateOption);
+
+    QCommandLineOption ocrSocketOption(
+        "ocr-socket",
+        "Stream the committed crop to a warm OCR worker on this Unix socket and print its result",
+        "path");
+    parser.addOption(ocrSocketOption);
+
+    QCommandLineOption scanCodesOption(
+        "scan-codes",
+        "Decode QR codes and barcodes in the selection and print them before the result");
+    parser.addOption(scanCodesOption);
+
+    QCommandLineOption eventsOption(
+        "events",
+        "Print versioned JSON lifecycle events (EVENT lines) as the capture progresses");
+    parser.addOption(eventsOption);
+
+    QCommandLineOption previewOption(
+        "preview",
+        "Print a downscaled preview (CAPTURE_PREVIEW) of large selections before the full-size result");
+    parser.addOption(previewOption);
+
+    QCommandLineOption optimizeSizeOption(
+        "optimize-size",
+        "Write a lossless indexed PNG when the selection has at most 256 colours");
+    parser.addOption(optimizeSizeOption);
+
+    QCommandLineOption renderQualityOption(
+        "render-quality",
+        "Overlay effect quality: auto (adapt to frame times, default), full, reduced or minimal",
+        "level", "auto");
+    parser.addOption(renderQualityOption);
+
+    QCommandLineOption latencyProfileOption(
+        "latency-profile",
+        "Experimental: raise scheduling priority, pin GUI/render threads to quiet cores and mlock frames "
+        "where permitted");
+    parser.addOption(latencyProfileOption);
+
+    QCommandLineOption latencyStatsOption(
+        "latency-stats",
+        "Log overlay frame-time percentiles at exit");
+    parser.addOption(latencyStatsOption);
+
+    QCommandLineOption noHugePagesOption(
+        "no-huge-pages",
+        "Back frame buffers with regular pages (for comparing grab cost)");
+    parser.addOption(noHugePagesOption);
+
+    QCommandLineOption trainOption(
+        "pgo-train",
+        "Run the scripted profile-training session instead of waiting for input");
+    trainOption.setFlags(QCommandLineOption::HiddenFromHelp);
+    parser.addOption(trainOption);
+
     parser.process(app);
 
+    LifecycleEvents::setEnabled(parser.isSet(eventsOption));
+
+    if (parser.isSet(noHugePagesOption))
+        FramePool::instance().setHugePages(false);
+
+    const bool latencyProfile = parser.isSet(latencyProfileOption);
+    if (latencyProfile)
+        LatencyProfile::applyToProcess();
+
     QString captureMode = "freeshape";
-    if (parser.isSet(rectangleOption))
+    const bool regionHandoff = parser.isSet(scrollOption) || parser.isSet(recordOption);
+    if (parser.isSet(rectangleOption) || regionHandoff)
     {
         captureMode = "rectangle";
         qDebug() << "Capture mode: Rectangle";
@@ -142,12 +308,46 @@ int main(int argc, char *argv[])
         qDebug() << "Capture mode: Freeshape";
     }
 
+    // Every return below joins the reserve thread before static teardown.
+    const auto joinReserve = qScopeGuard([]() { FramePool::instance().finishReserve(); });
+    if (!parser.isSet(loadSessionOption))
+    {
+        // Fault the full-screen frames in on a helper thread while the
+        // grabber is created and the display server is queried.
+#ifdef Q_OS_WIN
+        const QImage::Format grabFormat = QImage::Format_ARGB32;
+#else
+        const QImage::Format grabFormat = QImage::Format_RGB32;
+#endif
+        std::vector<std::pair<QSize, QImage::Format>> shapes;
+        for (QScreen *screen : app.screens())
+            shapes.emplace_back((QSizeF(screen->geometry().size()) * screen->devicePixelRatio()).toSize(), grabFormat);
+        FramePool::instance().reserveAsync(std::move(shapes));
+    }
+
     ScreenGrabber *engine = nullptr;
+    if (parser.isSet(loadSessionOption))
+    {
+        engine = createSessionEngine(parser.value(loadSessionOption), &app);
+    }
+    else if (parser.isSet(reopenOption))
+    {
+        const QString sessionPath = CaptureHistory::sessionPath(parser.value(reopenOption).toInt());
+        if (sessionPath.isEmpty())
+        {
+            qCritical() << "FATAL: No capture history entry" << parser.value(reopenOption);
+            return 1;
+        }
+        engine = createHistoryEngine(sessionPath, &app);
+    }
+    else
+    {
 #ifdef Q_OS_WIN
-    engine = createWindowsEngine(&app);
+        engine = createWindowsEngine(&app);
 #else
-    engine = createUnixEngine(&app);
+        engine = createUnixEngine(&app);
 #endif
+    }
 
     if (!engine)
     {
@@ -155,7 +355,103 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    std::vector<CapturedFrame> frames = engine->captureAll();
+    if (parser.isSet(watchOption))
+    {
+#ifdef Q_OS_LINUX
+        QRect region;
+        if (!parseRegion(parser.value(watchOption), &region))
+        {
+            qCritical() << "FATAL: --watch expects x,y,w,h, got" << parser.value(watchOption);
+            return 1;
+        }
+
+        RegionWatcher watcher(region);
+        if (!watcher.start())
+            return 1;
+        return app.exec();
+#else
+        qCritical() << "FATAL: --watch is only supported on Linux/X11.";
+        return 1;
+#endif
+    }
+
+    if (parser.isSet(windowOption))
+    {
+        bool ok = false;
+        const quint64 windowId = parser.value(windowOption).toULongLong(&ok, 0);
+        std::optional<CapturedFrame> frame = ok ? engine->captureWindow(windowId) : std::nullopt;
+
+        CaptureController controller;
+        if (!frame)
+        {
+            qCritical() << "FATAL: Window capture failed for" << parser.value(windowOption);
+            controller.cancel();
+            return 1;
+        }
+        return controller.saveImage(frame->image) ? 0 : 1;
+    }
+
+    // Live grabs use the backend measured fastest for this display setup.
+    // A setup seen for the first time is measured right here, and the
+    // winner's frames become this capture.
+    const bool liveGrab = !parser.isSet(loadSessionOption) && !parser.isSet(reopenOption);
+    if (parser.isSet(calibrateOption) && !liveGrab)
+    {
+        qCritical() << "FATAL: --calibrate needs a live grab, not a session or history entry.";
+        return 1;
+    }
+
+    const QString tuningKey = liveGrab ? CaptureTuning::configurationKey() : QString();
+    CaptureTuning::Tuning tuning = liveGrab ? CaptureTuning::load(tuningKey) : CaptureTuning::Tuning();
+    const bool calibrate = liveGrab && engine->backends().size() > 1
+        && (parser.isSet(calibrateOption) || !tuning.calibrated);
+
+    // This thread's faults only; the reserve thread reports its own.
+    const qint64 faultsBefore = FramePool::threadPageFaults();
+    QElapsedTimer grabClock;
+    grabClock.start();
+
+    std::vector<CapturedFrame> frames;
+    if (calibrate)
+    {
+        const int runs = parser.isSet(calibrateOption) ? CaptureTuning::kFullRuns : CaptureTuning::kQuickRuns;
+        tuning.backend = CaptureTuning::pickBackend(engine, runs, &tuning.grabMs, &frames);
+        tuning.calibrated = true;
+        qInfo() << "Calibrated grab backend for" << tuningKey << ":"
+                << (tuning.backend.isEmpty() ? QStringLiteral("default order") : tuning.backend);
+        // What a first capture on this setup pays over a calibrated one.
+        qInfo() << "Calibration added" << grabClock.nsecsElapsed() / 1e6 - qMax(0.0, tuning.grabMs)
+                << "ms before the overlay";
+    }
+    if (frames.empty())
+    {
+        engine->setPreferredBackend(tuning.backend);
+        frames = engine->captureAll();
+    }
+    const double grabMs = grabClock.nsecsElapsed() / 1e6;
+
+    if (parser.isSet(calibrateOption))
+    {
+        if (!frames.empty())
+            tuning.encoderThreads = CaptureTuning::pickEncoderThreads(frames.front().image, CaptureTuning::kFullRuns);
+        tuning.calibrated = true;
+        CaptureTuning::store(tuningKey, tuning);
+
+        std::cout << "CALIBRATED" << std::endl;
+        std::cout << QJsonDocument(QJsonObject{
+                                       {"key", tuningKey},
+                                       {"backend", tuning.backend},
+                                       {"grab_ms", tuning.grabMs},
+                                       {"encoder_threads", tuning.encoderThreads},
+                                   }).toJson(QJsonDocument::Compact).toStdString()
+                  << std::endl;
+        return frames.empty() ? 1 : 0;
+    }
+    if (calibrate)
+        CaptureTuning::store(tuningKey, tuning);
+
+    qInfo() << "Grabbed" << frames.size() << "screens in" << grabMs << "ms,"
+            << (faultsBefore < 0 ? -1 : FramePool::threadPageFaults() - faultsBefore) << "page faults";
 
     if (frames.empty())
     {
@@ -163,12 +459,66 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    if (LifecycleEvents::isEnabled())
+    {
+        QJsonArray displays;
+        for (const auto &frame : frames)
+        {
+            displays.append(QJsonObject{
+                {"index", frame.index},
+                {"name", frame.name},
+                {"geometry", LifecycleEvents::rect(frame.geometry)},
+                {"dpr", frame.devicePixelRatio},
+                {"mirror_of", frame.mirrorOf},
+            });
+        }
+        LifecycleEvents::post("frames_grabbed", {{"grab_ms", grabMs}, {"displays", displays}});
+    }
+
+    if (parser.isSet(dumpSessionOption))
+    {
+        const QString sessionPath = parser.value(dumpSessionOption);
+        if (SessionFile::write(sessionPath, frames))
+            qInfo() << "Session written to" << sessionPath;
+    }
+
+    std::shared_ptr<WindowIndex> windowIndex;
+    if (captureMode == "rectangle")
+    {
+        windowIndex = std::make_shared<WindowIndex>();
+        windowIndex->build(engine->windowGeometries());
+        qDebug() << "Indexed" << windowIndex->size() << "windows for snapping";
+    }
+
+    // Post-commit write, preview and code scan; destroyed after app.exec()
+    // returns, which finishes whatever is still queued.
+    JobPool jobs(tuning.encoderThreads);
+
+    // Fresh grabs go to the history once the result is out, if asked to:
+    // the frames hold whatever was on screen, not just the selection.
+    HistoryWriter history;
+    const bool storeHistory = parser.isSet(historyOption) && !parser.isSet(reopenOption)
+        && !parser.isSet(loadSessionOption) && CaptureHistory::isAvailable();
+
+    OcrClient *ocrClient = nullptr;
+    if (parser.isSet(ocrSocketOption))
+        ocrClient = new OcrClient(parser.value(ocrSocketOption), &app);
+
+    CodeScanner *codeScanner = nullptr;
+    if (parser.isSet(scanCodesOption))
+    {
+        if (!CodeScanner::isAvailable())
+            qWarning() << "Built without zxing-cpp: --scan-codes will always report CODE_NONE";
+        codeScanner = new CodeScanner(&app);
+    }
+
     QList<QScreen *> qtScreens = app.screens();
 
     QQmlApplicationEngine qmlEngine;
 
     std::vector<CaptureController *> controllers;
     std::vector<QQuickWindow *> windows;
+    std::vector<std::unique_ptr<FrameTimeRecorder>> frameTimes;
 
     for (const auto &frame : frames)
     {
@@ -177,6 +527,15 @@ int main(int argc, char *argv[])
                  << "|" << frame.geometry
                  << "| DPR:" << frame.devicePixelRatio;
 
+        if (frame.mirrorOf >= 0)
+        {
+            // A cloned output scans out the same desktop area, so the overlay
+            // of the display it mirrors already shows up on it. A second
+            // window would only add another texture and render loop.
+            qDebug() << "Display" << frame.index << "mirrors display" << frame.mirrorOf << "- reusing its overlay";
+            continue;
+        }
+
         QScreen *targetScreen = nullptr;
         for (QScreen *s : qtScreens)
         {
@@ -202,8 +561,52 @@ int main(int argc, char *argv[])
         controller->setDisplayIndex(frame.index);
         controller->setCaptureMode(captureMode);
         controller->setBackgroundImage(frame.image, frame.devicePixelRatio);
+        controller->setScreenGeometry(frame.geometry);
+        controller->setWindowIndex(windowIndex);
+        controller->setOcrClient(ocrClient);
+        controller->setCodeScanner(codeScanner);
+        controller->setJobPool(&jobs);
+        controller->setSizeOptimized(parser.isSet(optimizeSizeOption));
+        controller->setPreviewEnabled(parser.isSet(previewOption));
         controllers.push_back(controller);
 
+        if (storeHistory)
+        {
+            QObject::connect(controller, &CaptureController::captureCompleted, &app,
+                             [&history, &frames]() { history.start(frames); });
+        }
+
+        if (regionHandoff)
+        {
+            QScreen *grabScreen = targetScreen ? targetScreen : app.primaryScreen();
+            controller->setRegionHandoff(true);
+            QObject::connect(controller, &CaptureController::regionCommitted, &app,
+                             [&app, &parser, &windows, &scrollOption, &recordOption, &fpsOption,
+                              engine, controller, grabScreen](const QRect &rect)
+                             {
+                                 app.setQuitOnLastWindowClosed(false);
+                                 for (QQuickWindow *w : windows)
+                                     w->hide();
+
+                                 if (parser.isSet(scrollOption))
+                                 {
+                                     auto *scroll = new ScrollCapture(engine, grabScreen, rect, controller);
+                                     QObject::connect(scroll, &ScrollCapture::finished, controller, &CaptureController::emitSuccess);
+                                     QObject::connect(scroll, &ScrollCapture::failed, controller, &CaptureController::emitFailure);
+                                     scroll->start();
+                                 }
+                                 else
+                                 {
+                                     auto *recorder = new RegionRecorder(engine, grabScreen, rect,
+                                                                         parser.value(fpsOption).toInt(),
+                                                                         parser.value(recordOption).toInt(), controller);
+                                     QObject::connect(recorder, &RegionRecorder::finished, controller, &CaptureController::emitSuccess);
+                                     QObject::connect(recorder, &RegionRecorder::failed, controller, &CaptureController::emitFailure);
+                                     recorder->start();
+                                 }
+                             });
+        }
+
         QQmlComponent component(&qmlEngine, QUrl("qrc:/CaptureQml/qml/CaptureWindow.qml"));
         
         if (component.isError())
@@ -212,8 +615,18 @@ int main(int argc, char *argv[])
             return 1;
         }
 
+        auto *governor = new QualityGovernor(controller);
+        const QString renderQuality = parser.value(renderQualityOption);
+        if (renderQuality == "full")
+            governor->setFixedLevel(QualityGovernor::Full);
+        else if (renderQuality == "reduced")
+            governor->setFixedLevel(QualityGovernor::Reduced);
+        else if (renderQuality == "minimal")
+            governor->setFixedLevel(QualityGovernor::Minimal);
+
         QVariantMap properties;
         properties["controller"] = QVariant::fromValue(controller);
+        properties["governor"] = QVariant::fromValue(governor);
 
         QObject *obj = component.createWithInitialProperties(properties);
         QQuickWindow *window = qobject_cast<QQuickWindow *>(obj);
@@ -225,6 +638,7 @@ int main(int argc, char *argv[])
         }
 
         windows.push_back(window);
+        governor->attach(window);
 
         if (targetScreen)
         {
@@ -238,8 +652,55 @@ int main(int argc, char *argv[])
 
         applyPlatformWindowHacks(window);
 
+        if (latencyProfile)
+        {
+            QObject::connect(window, &QQuickWindow::sceneGraphInitialized, window, []()
+                             { LatencyProfile::applyToCurrentThread("render"); }, Qt::DirectConnection);
+        }
+
+        if (parser.isSet(latencyStatsOption))
+        {
+            frameTimes.push_back(std::make_unique<FrameTimeRecorder>(frame.name));
+            FrameTimeRecorder *recorder = frameTimes.back().get();
+            QObject::connect(window, &QQuickWindow::frameSwapped, window, [recorder]()
+                             { recorder->tick(); }, Qt::DirectConnection);
+        }
+
+        if (LifecycleEvents::isEnabled())
+        {
+            // frameSwapped fires on the render thread; the queued hop
+            // reports the first presented frame from the GUI thread.
+            QObject::connect(window, &QQuickWindow::frameSwapped, &app, [index = frame.index]()
+                             { LifecycleEvents::post("overlay_visible", {{"display", index}}); },
+                             static_cast<Qt::ConnectionType>(Qt::QueuedConnection | Qt::SingleShotConnection));
+        }
+
         window->showFullScreen();
     }
 
-    return app.exec();
+    if (parser.isSet(trainOption) && !windows.empty())
+    {
+        auto *training = new TrainingWorkload(windows.front(), frames, &app);
+        QTimer::singleShot(0, training, &TrainingWorkload::start);
+    }
+
+    // Last, so the job pool, the pool's reserve thread and Qt's own
+    // threads, all started by now, do not inherit SCHED_RR and the pinning.
+    if (latencyProfile)
+        LatencyProfile::applyToCurrentThread("gui");
+
+    const int exitCode = app.exec();
+    for (const auto &recorder : frameTimes)
+        recorder->report();
+    FramePool::instance().logStats();
+
+    if (history.isStarted())
+    {
+        // Everything the host reads is printed; close stdout so it sees
+        // EOF and unmutes. It keeps the instance lock until this returns.
+        std::cout.flush();
+        std::fclose(stdout);
+        history.wait();
+    }
+    return exitCode;
 }
@@ -0,0 +1,215 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "RegionRecorder.h"
+#include "ApngWriter.h"
+#include "LatencyProfile.h"
+#include "RowHash.h"
+#include "ScreenGrabber.h"
+#include <QDir>
+#include <QDebug>
+#include <QScreen>
+
+RegionRecorder::RegionRecorder(ScreenGrabber *grabber, QScreen *screen, const QRect &logicalRect,
+                               int fps, int durationSec, QObject *parent)
+    : QObject(parent), m_grabber(grabber), m_screen(screen), m_rect(logicalRect),
+      m_fps(qBound(1, fps, 60)), m_durationMs(qMax(1, durationSec) * 1000)
+{
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_timer.setInterval(1000 / m_fps);
+    connect(&m_timer, &QTimer::timeout, this, &RegionRecorder::tick);
+}
+
+RegionRecorder::~RegionRecorder()
+{
+    if (m_encoder.joinable())
+    {
+        Delta end;
+        end.last = true;
+        while (!m_ring.push(end))
+            std::this_thread::yield();
+        m_ready.release();
+        m_encoder.join();
+    }
+}
+
+void RegionRecorder::start()
+{
+    m_path = QDir::temp().filePath("spatial_recording.png");
+    QTimer::singleShot(kSettleMs, this, [this]()
+                       {
+                           m_clock.start();
+                           m_cpuStart = std::clock();
+                           m_timer.start();
+                           tick(); });
+    qDebug() << "[RegionRecorder] Recording" << m_rect << "at" << m_fps << "fps for" << m_durationMs << "ms";
+}
+
+QRect RegionRecorder::changedRect(const QImage &frame, std::vector<uint64_t> &hashes) const
+{
+    const int w = frame.width();
+    const int h = frame.height();
+
+    hashes.resize(size_t(h));
+    int top = -1;
+    int bottom = -1;
+    for (int y = 0; y < h; ++y)
+    {
+        hashes[y] = RowHash::hashRow(reinterpret_cast<const uint32_t *>(frame.constScanLine(y)), w);
+        if (hashes[y] != m_prevHashes[y])
+        {
+            if (top < 0)
+                top = y;
+            bottom = y;
+        }
+    }
+    if (top < 0)
+        return QRect();
+
+    int left = w;
+    int right = -1;
+    for (int y = top; y <= bottom; ++y)
+    {
+        const QRgb *a = reinterpret_cast<const QRgb *>(frame.constScanLine(y));
+        const QRgb *b = reinterpret_cast<const QRgb *>(m_prev.constScanLine(y));
+        int x = 0;
+        while (x < left && a[x] == b[x])
+            ++x;
+        left = qMin(left, x);
+        x = w - 1;
+        while (x > right && a[x] == b[x])
+            --x;
+        right = qMax(right, x);
+    }
+    if (right < left)
+        return QRect();
+
+    return QRect(QPoint(left, top), QPoint(right, bottom));
+}
+
+void RegionRecorder::tick()
+{
+    const qint64 now = m_clock.elapsed();
+    if (now >= m_durationMs)
+    {
+        stop();
+        return;
+    }
+
+    QImage frame = m_grabber->grabRegion(m_screen, m_rect).convertToFormat(QImage::Format_RGB32);
+    if (frame.isNull() || (!m_prev.isNull() && frame.size() != m_prev.size()))
+    {
+        qWarning() << "[RegionRecorder] Grab failed";
+        m_timer.stop();
+        emit failed();
+        return;
+    }
+    ++m_grabbed;
+
+    Delta delta;
+    delta.timestampMs = now;
+
+    // Diffs are taken against the last frame the encoder received, not the
+    // last one grabbed: the APNG composes each patch over its predecessor,
+    // so a dropped delta must be folded into the next one.
+    std::vector<uint64_t> hashes;
+    if (m_prev.isNull())
+    {
+        delta.rect = frame.rect();
+        delta.patch = frame;
+        hashes.resize(size_t(frame.height()));
+        for (int y = 0; y < frame.height(); ++y)
+            hashes[y] = RowHash::hashRow(reinterpret_cast<const uint32_t *>(frame.constScanLine(y)), frame.width());
+        if (!m_encoder.joinable())
+            m_encoder = std::thread(&RegionRecorder::encoderLoop, this, frame.size());
+    }
+    else
+    {
+        delta.rect = changedRect(frame, hashes);
+        if (delta.rect.isEmpty())
+            return;
+        delta.patch = frame.copy(delta.rect);
+    }
+
+    if (!m_ring.push(std::move(delta)))
+    {
+        ++m_dropped;
+        return;
+    }
+    m_prev = frame;
+    m_prevHashes = std::move(hashes);
+    m_ready.release();
+}
+
+void RegionRecorder::stop()
+{
+    m_timer.stop();
+    if (!m_encoder.joinable())
+    {
+        emit failed();
+        return;
+    }
+
+    const qint64 elapsed = m_clock.elapsed();
+    const double cpuMs = double(std::clock() - m_cpuStart) * 1000.0 / CLOCKS_PER_SEC;
+
+    Delta end;
+    end.last = true;
+    end.timestampMs = elapsed;
+    while (!m_ring.push(end))
+        std::this_thread::yield();
+    m_ready.release();
+    m_encoder.join();
+
+    // Encoder CPU is included: std::clock() is process-wide.
+    qInfo().nospace() << "[RegionRecorder] " << m_grabbed << " frames in " << elapsed << " ms ("
+                      << (elapsed > 0 ? m_grabbed * 1000.0 / elapsed : 0.0) << " fps sustained, "
+                      << (m_grabbed > 0 ? cpuMs / m_grabbed : 0.0) << " ms CPU/frame, "
+                      << m_dropped << " dropped, " << m_encoded << " written at "
+                      << (m_encoded > 0 ? m_encodeNs / 1e6 / m_encoded : 0.0) << " ms encode/frame) for "
+                      << m_prev.width() << "x" << m_prev.height();
+
+    if (m_encodeOk)
+        emit finished(m_path);
+    else
+        emit failed();
+}
+
+void RegionRecorder::encoderLoop(QSize size)
+{
+    LatencyProfile::resetCurrentThread();
+    ApngWriter writer;
+    bool ok = writer.open(m_path, size);
+
+    // A frame is written once the next one arrives, which fixes its delay.
+    Delta pending;
+    bool hasPending = false;
+
+    while (true)
+    {
+        m_ready.acquire();
+        Delta next;
+        if (!m_ring.pop(next))
+            continue;
+
+        if (hasPending && ok)
+        {
+            QElapsedTimer encodeTimer;
+            encodeTimer.start();
+            ok = writer.addFrame(pending.patch, pending.rect, int(next.timestampMs - pending.timestampMs));
+            m_encodeNs += encodeTimer.nsecsElapsed();
+            ++m_encoded;
+        }
+
+        if (next.last)
+            break;
+
+        pending = std::move(next);
+        hasPending = true;
+    }
+
+    m_encodeOk = ok && writer.finish();
+}
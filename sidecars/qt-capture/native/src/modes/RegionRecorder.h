@@ -0,0 +1,96 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef REGIONRECORDER_H
+#define REGIONRECORDER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QRect>
+#include <QSemaphore>
+#include <QTimer>
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+#include "SpscRing.h"
+
+class QScreen;
+class ScreenGrabber;
+
+/**
+ * @brief Records a selected region to an animated PNG.
+ *
+ * The region is grabbed at a fixed rate through the grabber's live path.
+ * Each frame is diffed against the last one queued and only the changed
+ * bounding rectangle is queued; unchanged frames just extend the previous
+ * frame's delay. Encoding runs on a worker thread fed by a lock-free ring.
+ * Sustained frame rate, CPU time per frame and the encoder's wall time per
+ * written frame (full or delta) are logged when done.
+ */
+class RegionRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    RegionRecorder(ScreenGrabber *grabber, QScreen *screen, const QRect &logicalRect,
+                   int fps, int durationSec, QObject *parent = nullptr);
+    ~RegionRecorder() override;
+
+    void start();
+
+signals:
+    void finished(const QString &path);
+    void failed();
+
+private slots:
+    void tick();
+
+private:
+    struct Delta
+    {
+        QImage patch;
+        QRect rect;
+        qint64 timestampMs = 0;
+        bool last = false;
+    };
+
+    void stop();
+    QRect changedRect(const QImage &frame, std::vector<uint64_t> &hashes) const;
+    void encoderLoop(QSize size);
+
+    static constexpr size_t kRingSize = 8;
+    static constexpr int kSettleMs = 150;
+
+    ScreenGrabber *m_grabber;
+    QScreen *m_screen;
+    QRect m_rect;
+    int m_fps;
+    int m_durationMs;
+
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    std::clock_t m_cpuStart = 0;
+    QImage m_prev; ///< Last frame queued to the encoder
+    std::vector<uint64_t> m_prevHashes;
+    int m_grabbed = 0;
+    int m_dropped = 0;
+
+    SpscRing<Delta, kRingSize> m_ring;
+    QSemaphore m_ready;
+    std::thread m_encoder;
+    std::atomic<bool> m_encodeOk{true};
+    std::atomic<qint64> m_encodeNs{0}; ///< Encoder time spent in addFrame()
+    std::atomic<int> m_encoded{0};
+    QString m_path;
+};
+
+#endif // REGIONRECORDER_H
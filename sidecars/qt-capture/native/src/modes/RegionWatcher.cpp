@@ -0,0 +1,211 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "RegionWatcher.h"
+#include "XcbShmImage.h"
+#include "FramePool.h"
+#include "LatencyProfile.h"
+#include <QCoreApplication>
+#include <QGuiApplication>
+#include <QDir>
+#include <QDebug>
+#include <QtGui/qguiapplication_platform.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+RegionWatcher::RegionWatcher(const QRect &region, QObject *parent)
+    : QObject(parent), m_region(region)
+{
+    m_coalesce.setSingleShot(true);
+    m_coalesce.setInterval(kCoalesceMs);
+    connect(&m_coalesce, &QTimer::timeout, this, &RegionWatcher::flushDamage);
+}
+
+RegionWatcher::~RegionWatcher()
+{
+    QCoreApplication::instance()->removeNativeEventFilter(this);
+
+    if (m_running.exchange(false))
+    {
+        m_ready.release();
+        m_encoder.join();
+    }
+
+    if (m_damage)
+    {
+        xcb_damage_destroy(m_conn, m_damage);
+        xcb_flush(m_conn);
+    }
+}
+
+bool RegionWatcher::start()
+{
+    auto *x11 = qGuiApp->nativeInterface<QNativeInterface::QX11Application>();
+    if (!x11 || !x11->connection())
+    {
+        qCritical() << "[RegionWatcher] Watch mode requires an X11 connection";
+        return false;
+    }
+    m_conn = x11->connection();
+    const xcb_screen_t *screen = xcb_setup_roots_iterator(xcb_get_setup(m_conn)).data;
+    m_root = screen->root;
+
+    m_region = m_region.intersected(QRect(0, 0, screen->width_in_pixels, screen->height_in_pixels));
+    if (m_region.isEmpty())
+    {
+        qCritical() << "[RegionWatcher] Watch region is outside the desktop";
+        return false;
+    }
+
+    const xcb_query_extension_reply_t *ext = xcb_get_extension_data(m_conn, &xcb_damage_id);
+    xcb_damage_query_version_reply_t *version = ext && ext->present
+        ? xcb_damage_query_version_reply(m_conn, xcb_damage_query_version(m_conn, 1, 1), nullptr)
+        : nullptr;
+    if (!version)
+    {
+        qCritical() << "[RegionWatcher] XDamage extension not available";
+        return false;
+    }
+    free(version);
+    m_damageEvent = ext->first_event + XCB_DAMAGE_NOTIFY;
+
+    m_shm = std::make_unique<XcbShmImage>(m_conn);
+    m_buffer = QImage(m_region.size(), QImage::Format_RGB32);
+    m_buffer.fill(Qt::black);
+    // Published copies cycle through the ring; keep that many ready.
+    FramePool::instance().reserve(m_region.size(), QImage::Format_RGB32, int(kRingSize) + 1);
+
+    m_running = true;
+    m_encoder = std::thread(&RegionWatcher::encoderLoop, this);
+
+    if (!regrab(m_region))
+    {
+        qCritical() << "[RegionWatcher] Initial grab of" << m_region << "failed";
+        return false;
+    }
+    publish();
+
+    QCoreApplication::instance()->installNativeEventFilter(this);
+    m_damage = xcb_generate_id(m_conn);
+    xcb_damage_create(m_conn, m_damage, m_root, XCB_DAMAGE_REPORT_LEVEL_RAW_RECTANGLES);
+    xcb_flush(m_conn);
+
+    qDebug() << "[RegionWatcher] Watching" << m_region;
+    return true;
+}
+
+bool RegionWatcher::nativeEventFilter(const QByteArray &eventType, void *message, qintptr *result)
+{
+    Q_UNUSED(result);
+    if (eventType != "xcb_generic_event_t")
+        return false;
+
+    auto *event = static_cast<xcb_generic_event_t *>(message);
+    if ((event->response_type & ~0x80) != m_damageEvent)
+        return false;
+
+    auto *notify = reinterpret_cast<xcb_damage_notify_event_t *>(event);
+    if (notify->damage != m_damage)
+        return false;
+
+    const QRect area(notify->area.x, notify->area.y, notify->area.width, notify->area.height);
+    const QRect hit = area.intersected(m_region);
+    if (!hit.isEmpty())
+    {
+        m_pending += hit;
+        if (!m_coalesce.isActive())
+            m_coalesce.start();
+    }
+    return true;
+}
+
+void RegionWatcher::flushDamage()
+{
+    bool changed = false;
+    for (const QRect &rect : m_pending)
+        changed |= regrab(rect);
+    m_pending = QRegion();
+
+    if (changed)
+        publish();
+}
+
+bool RegionWatcher::regrab(const QRect &rect)
+{
+    QImage grabbed = m_shm->grab(m_root, rect);
+    if (grabbed.isNull())
+        return false;
+
+    const QPoint offset = rect.topLeft() - m_region.topLeft();
+    const size_t rowBytes = size_t(rect.width()) * 4;
+    bool changed = false;
+
+    for (int y = 0; y < rect.height(); ++y)
+    {
+        uchar *dst = m_buffer.scanLine(offset.y() + y) + offset.x() * 4;
+        const uchar *src = grabbed.constScanLine(y);
+        if (memcmp(dst, src, rowBytes) != 0)
+        {
+            memcpy(dst, src, rowBytes);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void RegionWatcher::publish()
+{
+    // With every slot taken the buffer is only marked dirty; the encoder
+    // asks for a republish whenever it frees a slot, so the latest state
+    // always goes out even if no further damage arrives.
+    if (!m_ring.push(FramePool::instance().copy(m_buffer)))
+    {
+        m_dirty = true;
+        return;
+    }
+    m_dirty = false;
+    m_ready.release();
+}
+
+void RegionWatcher::republish()
+{
+    if (m_dirty)
+        publish();
+}
+
+void RegionWatcher::encoderLoop()
+{
+    LatencyProfile::resetCurrentThread();
+    quint64 sequence = 0;
+    while (true)
+    {
+        m_ready.acquire();
+        if (!m_running)
+            break;
+
+        QImage frame;
+        if (!m_ring.pop(frame))
+            continue;
+        QMetaObject::invokeMethod(this, &RegionWatcher::republish, Qt::QueuedConnection);
+
+        // Rotate over as many files as the ring can hold so a reader never
+        // sees a file that is being rewritten under it.
+        const QString path = QDir::temp().filePath(
+            QString("spatial_watch_%1.png").arg(sequence++ % (kRingSize + 1)));
+
+        if (frame.save(path, "PNG"))
+        {
+            std::cout << "WATCH_FRAME" << std::endl;
+            std::cout << path.toStdString() << std::endl;
+            std::cout.flush();
+        }
+        else
+        {
+            qWarning() << "[RegionWatcher] Failed to save frame to" << path;
+        }
+    }
+}
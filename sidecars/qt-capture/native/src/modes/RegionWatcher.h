@@ -0,0 +1,86 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef REGIONWATCHER_H
+#define REGIONWATCHER_H
+
+#include <QObject>
+#include <QAbstractNativeEventFilter>
+#include <QImage>
+#include <QRect>
+#include <QRegion>
+#include <QSemaphore>
+#include <QTimer>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <xcb/xcb.h>
+#include <xcb/damage.h>
+
+#include "SpscRing.h"
+
+class XcbShmImage;
+
+/**
+ * @brief Damage-driven continuous capture of one desktop region (X11).
+ *
+ * Subscribes to XDamage on the root window and only re-reads the damaged
+ * rectangles that intersect the region, through MIT-SHM, into a persistent
+ * buffer. Frames whose pixels really changed are handed to an encoder thread
+ * over a lock-free ring and announced on stdout as:
+ *
+ *     WATCH_FRAME
+ *     /tmp/spatial_watch_<n>.png
+ *
+ * When the encoder falls behind, intermediate frames are skipped but the
+ * latest state is always emitted. A static region costs no wakeups:
+ * nothing runs until the server reports damage.
+ */
+class RegionWatcher : public QObject, public QAbstractNativeEventFilter
+{
+    Q_OBJECT
+
+public:
+    explicit RegionWatcher(const QRect &region, QObject *parent = nullptr);
+    ~RegionWatcher() override;
+
+    bool start();
+
+    bool nativeEventFilter(const QByteArray &eventType, void *message, qintptr *result) override;
+
+private slots:
+    void flushDamage();
+
+private:
+    bool regrab(const QRect &rect);
+    void publish();
+    void republish();
+    void encoderLoop();
+
+    static constexpr size_t kRingSize = 4;
+    static constexpr int kCoalesceMs = 16;
+
+    QRect m_region;
+    QRegion m_pending;
+    QTimer m_coalesce;
+    QImage m_buffer;
+    bool m_dirty = false; ///< m_buffer changed but could not be queued yet
+
+    xcb_connection_t *m_conn = nullptr;
+    xcb_window_t m_root = 0;
+    xcb_damage_damage_t m_damage = 0;
+    uint8_t m_damageEvent = 0;
+    std::unique_ptr<XcbShmImage> m_shm;
+
+    SpscRing<QImage, kRingSize> m_ring;
+    QSemaphore m_ready;
+    std::atomic<bool> m_running{false};
+    std::thread m_encoder;
+};
+
+#endif // REGIONWATCHER_H
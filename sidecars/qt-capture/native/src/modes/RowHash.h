@@ -0,0 +1,86 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef ROWHASH_H
+#define ROWHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RowHash
+{
+/**
+ * Hashes one row of 32-bit pixels. Eight independent lanes keep the loop
+ * free of cross-iteration dependencies so compilers turn it into SIMD on
+ * every target we ship (SSE/AVX, NEON) without per-platform intrinsics.
+ */
+inline uint64_t hashRow(const uint32_t *pixels, int count)
+{
+    constexpr int kLanes = 8;
+    uint32_t lanes[kLanes] = {
+        0x811C9DC5u, 0x01000193u, 0x9E3779B9u, 0x85EBCA6Bu,
+        0xC2B2AE35u, 0x27D4EB2Fu, 0x165667B1u, 0xD3A2646Cu};
+
+    int i = 0;
+    for (; i + kLanes <= count; i += kLanes)
+        for (int l = 0; l < kLanes; ++l)
+            lanes[l] = (lanes[l] ^ pixels[i + l]) * 0x9E3779B1u;
+
+    for (; i < count; ++i)
+        lanes[i % kLanes] = (lanes[i % kLanes] ^ pixels[i]) * 0x9E3779B1u;
+
+    uint64_t h = uint64_t(count);
+    for (int l = 0; l < kLanes; ++l)
+        h = (h ^ lanes[l]) * 0x100000001B3ull;
+    return h;
+}
+
+/// Rows that are identical in both frames at the top (sticky headers).
+inline int commonPrefix(const std::vector<uint64_t> &a, const std::vector<uint64_t> &b)
+{
+    const size_t n = a.size() < b.size() ? a.size() : b.size();
+    size_t i = 0;
+    while (i < n && a[i] == b[i])
+        ++i;
+    return int(i);
+}
+
+/// Rows that are identical in both frames at the bottom (sticky footers).
+inline int commonSuffix(const std::vector<uint64_t> &a, const std::vector<uint64_t> &b, int limit)
+{
+    int i = 0;
+    while (i < limit && a[a.size() - 1 - i] == b[b.size() - 1 - i])
+        ++i;
+    return i;
+}
+
+/**
+ * Finds how many rows the band [begin, end) scrolled up between @p prev and
+ * @p curr, i.e. the smallest shift s with curr[begin + i] == prev[begin + i + s]
+ * over the whole remaining overlap. Returns 0 when no shift of at least
+ * @p minOverlap matching rows exists.
+ */
+inline int findScroll(const std::vector<uint64_t> &prev, const std::vector<uint64_t> &curr,
+                      int begin, int end, int minOverlap)
+{
+    const int band = end - begin;
+    for (int shift = 1; band - shift >= minOverlap; ++shift)
+    {
+        int i = 0;
+        const int overlap = band - shift;
+        while (i < overlap && curr[begin + i] == prev[begin + i + shift])
+            ++i;
+        if (i == overlap)
+            return shift;
+    }
+    return 0;
+}
+} // namespace RowHash
+
+#endif // ROWHASH_H
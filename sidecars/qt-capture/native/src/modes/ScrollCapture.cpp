@@ -0,0 +1,132 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ScrollCapture.h"
+#include "LifecycleEvents.h"
+#include "RowHash.h"
+#include "ScreenGrabber.h"
+#include <QDir>
+#include <QDebug>
+#include <QScreen>
+
+ScrollCapture::ScrollCapture(ScreenGrabber *grabber, QScreen *screen, const QRect &logicalRect, QObject *parent)
+    : QObject(parent), m_grabber(grabber), m_screen(screen), m_rect(logicalRect)
+{
+    m_timer.setInterval(kIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &ScrollCapture::tick);
+}
+
+void ScrollCapture::start()
+{
+    m_path = QDir::temp().filePath("spatial_capture.png");
+    m_idle.start();
+
+    // Give the compositor a moment to drop the hidden overlay before the
+    // first live grab.
+    QTimer::singleShot(kSettleMs, this, [this]()
+                       { m_timer.start(); tick(); });
+    qDebug() << "[ScrollCapture] Scroll the selected content; stops after"
+             << kIdleTimeoutMs << "ms without movement";
+}
+
+std::vector<uint64_t> ScrollCapture::hashFrame(const QImage &frame)
+{
+    std::vector<uint64_t> hashes(size_t(frame.height()));
+    for (int y = 0; y < frame.height(); ++y)
+        hashes[y] = RowHash::hashRow(reinterpret_cast<const uint32_t *>(frame.constScanLine(y)), frame.width());
+    return hashes;
+}
+
+bool ScrollCapture::commitRows(const QImage &frame, ScrollStitcher::Rows rows)
+{
+    if (rows.count <= 0)
+        return true;
+    return m_writer.appendRows(frame, rows.first, rows.count);
+}
+
+void ScrollCapture::tick()
+{
+    QImage frame = m_grabber->grabRegion(m_screen, m_rect).convertToFormat(QImage::Format_RGB32);
+    if (frame.isNull())
+    {
+        qWarning() << "[ScrollCapture] Grab failed";
+        m_timer.stop();
+        emit failed();
+        return;
+    }
+
+    if (m_prev.isNull())
+    {
+        if (!m_writer.open(m_path, frame.width()))
+        {
+            m_timer.stop();
+            emit failed();
+            return;
+        }
+        ScrollStitcher::Rows none;
+        m_stitcher.next(hashFrame(frame), none);
+        m_prev = frame;
+        return;
+    }
+
+    if (frame.size() != m_prev.size())
+        return;
+
+    // Rows that left the band at the top are final; write them out.
+    ScrollStitcher::Rows done;
+    switch (m_stitcher.next(hashFrame(frame), done))
+    {
+    case ScrollStitcher::Motion::Still:
+        if (m_idle.elapsed() > kIdleTimeoutMs)
+            finish();
+        return;
+    case ScrollStitcher::Motion::Scrolled:
+        if (!commitRows(m_prev, done))
+        {
+            m_timer.stop();
+            emit failed();
+            return;
+        }
+        m_idle.restart();
+        break;
+    case ScrollStitcher::Motion::Jumped:
+        qWarning() << "[ScrollCapture] Scrolled too far in one tick; the image has a gap at row"
+                   << m_writer.height() + done.count;
+        LifecycleEvents::post("scroll_gap", {{"row", m_writer.height() + done.count}});
+        if (!commitRows(m_prev, done))
+        {
+            m_timer.stop();
+            emit failed();
+            return;
+        }
+        m_idle.restart();
+        break;
+    case ScrollStitcher::Motion::Changed:
+        break;
+    }
+
+    m_prev = frame;
+
+    if (m_writer.height() + frame.height() > kMaxRows)
+        finish();
+}
+
+void ScrollCapture::finish()
+{
+    m_timer.stop();
+
+    // The last frame is still pending: everything below the sticky header.
+    if (!commitRows(m_prev, m_stitcher.remainder()) || !m_writer.finish())
+    {
+        qWarning() << "[ScrollCapture] Failed to write stitched image";
+        emit failed();
+        return;
+    }
+
+    qDebug() << "[ScrollCapture] Stitched" << m_writer.width() << "x" << m_writer.height()
+             << "with a" << qMax(0, m_stitcher.header()) << "row header";
+    emit finished(m_path);
+}
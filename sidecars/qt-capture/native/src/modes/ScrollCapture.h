@@ -0,0 +1,75 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef SCROLLCAPTURE_H
+#define SCROLLCAPTURE_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QRect>
+#include <QTimer>
+#include <cstdint>
+#include <vector>
+
+#include "PngStreamWriter.h"
+#include "ScrollStitcher.h"
+
+class QScreen;
+class ScreenGrabber;
+
+/**
+ * @brief Stitches a region into one tall image while its content scrolls.
+ *
+ * The region is re-grabbed on a timer. Per-row hashes of consecutive frames
+ * go through a ScrollStitcher, which finds the scroll offset (sticky headers
+ * and footers are kept out of the match), and rows that scroll out of view
+ * are streamed straight into a PngStreamWriter. Only the previous frame is
+ * ever held in memory. Capture ends once the content stays still for a
+ * while.
+ */
+class ScrollCapture : public QObject
+{
+    Q_OBJECT
+
+public:
+    ScrollCapture(ScreenGrabber *grabber, QScreen *screen, const QRect &logicalRect, QObject *parent = nullptr);
+
+    void start();
+
+signals:
+    void finished(const QString &path);
+    void failed();
+
+private slots:
+    void tick();
+
+private:
+    void finish();
+    bool commitRows(const QImage &frame, ScrollStitcher::Rows rows);
+    static std::vector<uint64_t> hashFrame(const QImage &frame);
+
+    static constexpr int kIntervalMs = 80;
+    static constexpr int kSettleMs = 150;
+    static constexpr int kIdleTimeoutMs = 2500;
+    static constexpr int kMaxRows = 60000;
+
+    ScreenGrabber *m_grabber;
+    QScreen *m_screen;
+    QRect m_rect;
+    QTimer m_timer;
+    QElapsedTimer m_idle;
+
+    QImage m_prev;
+    ScrollStitcher m_stitcher;
+
+    PngStreamWriter m_writer;
+    QString m_path;
+};
+
+#endif // SCROLLCAPTURE_H
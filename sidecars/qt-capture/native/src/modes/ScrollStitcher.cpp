@@ -0,0 +1,84 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ScrollStitcher.h"
+#include "RowHash.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// Fewer than half the rows unchanged in place: not an update within the
+// view (a caret, a hover, an animation) but content that moved.
+bool movedAway(const std::vector<uint64_t> &prev, const std::vector<uint64_t> &curr)
+{
+    size_t same = 0;
+    for (size_t i = 0; i < curr.size(); ++i)
+        same += prev[i] == curr[i];
+    return same * 2 < curr.size();
+}
+
+} // namespace
+
+ScrollStitcher::Motion ScrollStitcher::next(std::vector<uint64_t> hashes, Rows &done)
+{
+    done = Rows();
+    if (m_prev.empty())
+    {
+        m_prev = std::move(hashes);
+        return Motion::Still;
+    }
+    if (hashes.size() != m_prev.size())
+        return Motion::Still;
+
+    const int height = int(hashes.size());
+    const int prefix = RowHash::commonPrefix(m_prev, hashes);
+    if (prefix == height)
+        return Motion::Still;
+
+    const int header = m_header >= 0 ? m_header : prefix;
+    const int footer = RowHash::commonSuffix(m_prev, hashes, height - header);
+    const int band = height - header - footer;
+    const int shift = RowHash::findScroll(m_prev, hashes, header, height - footer, std::max(8, band / 8));
+
+    Motion motion = Motion::Changed;
+    if (shift > 0 && m_header < 0)
+    {
+        // Rows above the band that also match at the scrolled offset moved
+        // with it; only the ones that did not are the sticky header.
+        int top = header;
+        while (top > 0 && hashes[top - 1] == m_prev[top - 1 + shift])
+            --top;
+        m_header = top;
+        done = {0, top + shift};
+        motion = Motion::Scrolled;
+    }
+    else if (shift > 0)
+    {
+        done = {m_header, shift};
+        motion = Motion::Scrolled;
+    }
+    else if (movedAway(m_prev, hashes))
+    {
+        // No overlap, yet most rows changed: the content scrolled past the
+        // search window within one tick. Release the whole previous frame
+        // above the footer, header included if no scroll wrote it yet;
+        // whatever scrolled by unseen is lost.
+        const int first = m_header < 0 ? 0 : m_header;
+        m_header = header;
+        done = {first, std::max(0, height - footer - first)};
+        motion = Motion::Jumped;
+    }
+
+    m_prev = std::move(hashes);
+    return motion;
+}
+
+ScrollStitcher::Rows ScrollStitcher::remainder() const
+{
+    const int first = std::max(m_header, 0);
+    return {first, int(m_prev.size()) - first};
+}
@@ -0,0 +1,67 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef SCROLLSTITCHER_H
+#define SCROLLSTITCHER_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Decides which rows of a scrolling region are final.
+ *
+ * Fed the row hashes of consecutive frames, it finds how far the content
+ * scrolled and reports the rows of the previous frame that have left the
+ * view for good. The sticky header is fixed on the first detected scroll
+ * and only counts rows that stayed put while the content below them
+ * moved: rows that merely look the same in both frames (a blank top
+ * margin scrolling past) are content, not header. Later frames reuse the
+ * fixed header, so every document row is emitted exactly once.
+ */
+class ScrollStitcher
+{
+public:
+    enum class Motion
+    {
+        Still,    ///< Identical to the previous frame
+        Changed,  ///< Content changed without a detectable scroll
+        Scrolled, ///< Content moved up; rows were released
+        Jumped,   ///< Content moved further than the overlap search reaches;
+                  ///< the previous frame was released and rows may be missing
+    };
+
+    /// Rows [first, first + count) of the previous frame.
+    struct Rows
+    {
+        int first = 0;
+        int count = 0;
+    };
+
+    /**
+     * Compares @p hashes with the previous frame and adopts them as the
+     * new previous frame. On Scrolled, @p done receives the previous
+     * frame's rows that scrolled out (plus the header, the first time).
+     * On Jumped it receives every row of the previous frame above the
+     * footer, so nothing that was on screen is dropped.
+     * The first frame only seeds the state; one of another height is
+     * ignored.
+     */
+    Motion next(std::vector<uint64_t> hashes, Rows &done);
+
+    /// Rows of the last frame still to be written when capture ends.
+    Rows remainder() const;
+
+    /// Fixed header height, or -1 before the first scroll.
+    int header() const { return m_header; }
+
+private:
+    std::vector<uint64_t> m_prev;
+    int m_header = -1;
+};
+
+#endif // SCROLLSTITCHER_H
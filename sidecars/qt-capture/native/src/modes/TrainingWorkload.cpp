@@ -0,0 +1,93 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "TrainingWorkload.h"
+#include "FrameOps.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMouseEvent>
+#include <QQuickWindow>
+#include <QDebug>
+#include <cmath>
+
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586;
+
+} // namespace
+
+TrainingWorkload::TrainingWorkload(QQuickWindow *window, std::vector<CapturedFrame> frames, QObject *parent)
+    : QObject(parent)
+    , m_window(window)
+    , m_frames(std::move(frames))
+{
+    m_timer.setInterval(kStepMs);
+    connect(&m_timer, &QTimer::timeout, this, &TrainingWorkload::step);
+}
+
+void TrainingWorkload::start()
+{
+    cropAndEncode();
+    m_timer.start();
+}
+
+void TrainingWorkload::cropAndEncode()
+{
+    static const int kEdges[] = {32, 128, 512, 1024, 4096};
+
+    for (const CapturedFrame &frame : m_frames)
+    {
+        const QSizeF logical = QSizeF(frame.image.size()) / frame.devicePixelRatio;
+        for (int edge : kEdges)
+        {
+            const QRectF rect(0, 0, qMin<qreal>(edge, logical.width()), qMin<qreal>(edge, logical.height()));
+
+            QElapsedTimer clock;
+            clock.start();
+            const QImage cropped = FrameOps::crop(frame.image, rect, frame.devicePixelRatio);
+            const QByteArray png = FrameOps::encode(cropped, "PNG");
+            qInfo().nospace() << "[Training] crop+encode " << cropped.width() << "x" << cropped.height()
+                              << ": " << clock.nsecsElapsed() / 1e6 << " ms, " << png.size() << " bytes";
+        }
+    }
+}
+
+void TrainingWorkload::step()
+{
+    if (!m_window)
+    {
+        m_timer.stop();
+        return;
+    }
+
+    // A looping trace over most of the window: covers hover, drag and the
+    // squiggle point accumulation without leaving the screen.
+    const QSizeF size = m_window->size();
+    const double t = double(m_step) / kSteps;
+    const QPointF pos(size.width() * (0.5 + 0.35 * std::sin(kTwoPi * t)),
+                      size.height() * (0.5 + 0.35 * std::sin(2 * kTwoPi * t + 0.5)));
+
+    if (m_step == 0)
+        send(QEvent::MouseButtonPress, pos);
+    else if (m_step < kSteps)
+        send(QEvent::MouseMove, pos);
+    else
+    {
+        m_timer.stop();
+        send(QEvent::MouseButtonRelease, pos);
+        return;
+    }
+    ++m_step;
+}
+
+void TrainingWorkload::send(int type, const QPointF &pos)
+{
+    const bool release = type == QEvent::MouseButtonRelease;
+    QMouseEvent event(QEvent::Type(type), pos, m_window->mapToGlobal(pos),
+                      type == QEvent::MouseMove ? Qt::NoButton : Qt::LeftButton,
+                      release ? Qt::NoButton : Qt::LeftButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(m_window, &event);
+}
@@ -0,0 +1,53 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifndef TRAININGWORKLOAD_H
+#define TRAININGWORKLOAD_H
+
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <vector>
+
+#include "ScreenGrabber.h"
+
+class QQuickWindow;
+
+/**
+ * @brief Scripted session used to collect PGO profiles headlessly.
+ *
+ * Crops and encodes every frame at several sizes, then drives a mouse
+ * trace through the first overlay window with synthetic events and
+ * releases it, which commits the selection through the normal path and
+ * ends the process. Run once per canvas mode (-f, -r) under
+ * QT_QPA_PLATFORM=offscreen; see `cargo xtask build-capture-pgo`.
+ */
+class TrainingWorkload : public QObject
+{
+    Q_OBJECT
+
+public:
+    TrainingWorkload(QQuickWindow *window, std::vector<CapturedFrame> frames, QObject *parent = nullptr);
+
+    void start();
+
+private:
+    void cropAndEncode();
+    void step();
+    void send(int type, const QPointF &pos);
+
+    static constexpr int kSteps = 240;
+    static constexpr int kStepMs = 4;
+
+    QPointer<QQuickWindow> m_window;
+    std::vector<CapturedFrame> m_frames;
+    QTimer m_timer;
+    int m_step = 0;
+};
+
+#endif // TRAININGWORKLOAD_H
@@ -0,0 +1,114 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Smoke test of the capture_core C ABI, built as C against the shared
+ * library: the header compiles without C++, the struct layouts hosts were
+ * built against hold, argument errors are reported, and a grab into
+ * caller buffers works on the offscreen platform.
+ */
+
+#include "capture_core.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int g_failures = 0;
+
+static void check(const char *name, int ok)
+{
+    printf("%s %s\n", ok ? "PASS" : "FAIL", name);
+    if (!ok)
+        ++g_failures;
+}
+
+static void checkLayout(void)
+{
+    if (sizeof(void *) != 8)
+        return;
+
+    check("cc_frame_info layout", sizeof(cc_frame_info) == 104 && offsetof(cc_frame_info, name) == 36);
+    check("cc_pool_stats layout", sizeof(cc_pool_stats) == 32);
+    check("cc_frame_buffer layout",
+          sizeof(cc_frame_buffer) == 136 && offsetof(cc_frame_buffer, info) == 24
+              && offsetof(cc_frame_buffer, filled) == 128);
+}
+
+static void checkArguments(void)
+{
+    cc_frame_info info;
+    cc_frame_buffer buffer = {0};
+    int32_t frames = 0;
+
+    check("cc_capture without output", cc_capture(NULL) == CC_ERR_ARGUMENT);
+    check("cc_capture_into without buffers", cc_capture_into(NULL, 1, &frames) == CC_ERR_ARGUMENT);
+    check("cc_capture_into without count", cc_capture_into(&buffer, 0, &frames) == CC_ERR_ARGUMENT);
+    check("cc_capture_into without output", cc_capture_into(&buffer, 1, NULL) == CC_ERR_ARGUMENT);
+    check("cc_frame_count of no session", cc_frame_count(NULL) == 0);
+    check("cc_frame_info_get of no session", cc_frame_info_get(NULL, 0, &info) == CC_ERR_ARGUMENT);
+    check("cc_pool_stats_get without output", cc_pool_stats_get(NULL) == CC_ERR_ARGUMENT);
+    cc_buffer_free(NULL);
+    cc_session_free(NULL);
+}
+
+static void checkCaptureInto(void)
+{
+    cc_frame_info screens[8];
+    cc_frame_buffer buffers[8] = {{0}};
+    int32_t count = cc_enumerate_screens(screens, 8);
+    int32_t frames = 0;
+    cc_status status;
+    int32_t i;
+    int ok = 1;
+
+    check("cc_enumerate_screens", count > 0);
+    if (count <= 0)
+        return;
+    if (count > 8)
+        count = 8;
+
+    for (i = 0; i < count; ++i)
+    {
+        buffers[i].stride = (size_t)screens[i].pixel_width * 4;
+        buffers[i].size = buffers[i].stride * (size_t)screens[i].pixel_height;
+        buffers[i].data = (uint8_t *)malloc(buffers[i].size);
+    }
+
+    status = cc_capture_into(buffers, count, &frames);
+    if (status == CC_ERR_NO_FRAMES)
+    {
+        /* The offscreen platform has nothing to grab on some backends. */
+        printf("SKIP cc_capture_into: no frames on this platform\n");
+    }
+    else
+    {
+        check("cc_capture_into", status == CC_OK && frames > 0 && frames <= count);
+        for (i = 0; i < count; ++i)
+        {
+            if (buffers[i].filled
+                && ((size_t)buffers[i].info.pixel_width * 4 > buffers[i].stride
+                    || (size_t)buffers[i].info.pixel_height * buffers[i].stride > buffers[i].size))
+                ok = 0;
+        }
+        check("cc_capture_into frames fit their buffers", ok);
+    }
+
+    for (i = 0; i < count; ++i)
+        free(buffers[i].data);
+}
+
+int main(void)
+{
+    cc_pool_stats stats;
+
+    check("cc_abi_version", cc_abi_version() == CC_ABI_VERSION);
+    checkLayout();
+    checkArguments();
+    check("cc_pool_stats_get", cc_pool_stats_get(&stats) == CC_OK);
+    checkCaptureInto();
+
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Round-trips indexed PNGs through Qt's own decoder: every bit depth, odd
+ * widths that end mid-byte, translucent entries and RGB32 input with a
+ * junk alpha byte. Also checks that the histogram gives up past 256
+ * colours, which is what sends the caller to the truecolour encoder.
+ */
+
+#include "PalettePng.h"
+#include <QFile>
+#include <QImage>
+#include <QTemporaryDir>
+#include <cstdio>
+
+namespace {
+
+int g_failures = 0;
+
+void check(const char *name, bool ok)
+{
+    std::printf("%s %s\n", ok ? "PASS" : "FAIL", name);
+    if (!ok)
+        ++g_failures;
+}
+
+/// Image whose pixel (x, y) is colors[(x + y) % colors.size()].
+QImage pattern(int width, int height, const QVector<QRgb> &colors, QImage::Format format)
+{
+    QImage image(width, height, format);
+    for (int y = 0; y < height; ++y)
+    {
+        auto *row = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x)
+            row[x] = colors[(x + y) % colors.size()];
+    }
+    return image;
+}
+
+QVector<QRgb> opaqueColors(int count)
+{
+    QVector<QRgb> colors;
+    for (int i = 0; i < count; ++i)
+        colors.append(qRgb(i, 255 - i, (i * 37) & 0xff));
+    return colors;
+}
+
+/// Encodes @p image, decodes it with QImage and compares every pixel.
+bool roundTrips(const QTemporaryDir &dir, const QImage &image, const char *name)
+{
+    QVector<QRgb> palette;
+    if (!PalettePng::histogram(image, palette))
+        return false;
+
+    const QString path = dir.filePath(QString::fromLatin1(name) + ".png");
+    if (!PalettePng::write(image, palette, path))
+        return false;
+
+    // IHDR colour type, after the signature, chunk header and 9 bytes.
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || file.read(26).value(25) != 3)
+        return false;
+
+    const QImage decoded(path);
+    if (decoded.isNull() || decoded.size() != image.size())
+        return false;
+
+    // Converting RGB32 to ARGB32 forces alpha opaque, as the encoder does.
+    return decoded.convertToFormat(QImage::Format_ARGB32) == image.convertToFormat(QImage::Format_ARGB32);
+}
+
+} // namespace
+
+int main()
+{
+    QTemporaryDir dir;
+    if (!dir.isValid())
+    {
+        std::printf("FAIL temporary directory\n");
+        return 1;
+    }
+
+    check("1-bit palette round-trips", roundTrips(dir, pattern(13, 7, opaqueColors(2), QImage::Format_ARGB32), "bits1"));
+    check("2-bit palette round-trips", roundTrips(dir, pattern(11, 5, opaqueColors(4), QImage::Format_ARGB32), "bits2"));
+    check("4-bit palette round-trips", roundTrips(dir, pattern(9, 9, opaqueColors(16), QImage::Format_ARGB32), "bits4"));
+    check("8-bit palette round-trips", roundTrips(dir, pattern(300, 3, opaqueColors(256), QImage::Format_ARGB32), "bits8"));
+
+    QVector<QRgb> translucent = opaqueColors(5);
+    translucent.append(qRgba(10, 20, 30, 0));
+    translucent.append(qRgba(200, 100, 50, 128));
+    check("translucent entries round-trip through tRNS",
+          roundTrips(dir, pattern(17, 6, translucent, QImage::Format_ARGB32), "trns"));
+
+    // X servers leave the alpha byte of RGB32 undefined; it must not
+    // split one colour into several palette entries.
+    QVector<QRgb> junkAlpha = {0x12ff0000, 0x3400ff00, 0xff0000ff, 0x00ff0000};
+    QImage rgb32 = pattern(10, 4, junkAlpha, QImage::Format_RGB32);
+    QVector<QRgb> palette;
+    check("RGB32 alpha byte is ignored by the histogram",
+          PalettePng::histogram(rgb32, palette) && palette.size() == 3);
+    check("RGB32 with junk alpha round-trips opaque", roundTrips(dir, rgb32, "rgb32"));
+
+    check("exactly 256 colours stay indexed",
+          PalettePng::histogram(pattern(256, 1, opaqueColors(256), QImage::Format_ARGB32), palette)
+              && palette.size() == PalettePng::kMaxColors);
+
+    QVector<QRgb> many = opaqueColors(256);
+    many.append(qRgb(1, 2, 3));
+    check("257 colours fall back to truecolour",
+          !PalettePng::histogram(pattern(257, 2, many, QImage::Format_ARGB32), palette));
+
+    check("write rejects an oversized palette",
+          !PalettePng::write(pattern(4, 4, opaqueColors(2), QImage::Format_ARGB32), many,
+                             dir.filePath("oversized.png")));
+
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "QualityPolicy.h"
+#include <cstdio>
+
+namespace {
+
+constexpr double kBudget = 1000.0 / 60.0;
+constexpr int kMinimal = 0;
+constexpr int kFull = 2;
+
+int g_failures = 0;
+
+void check(const char *name, bool ok)
+{
+    std::printf("%s %s\n", ok ? "PASS" : "FAIL", name);
+    if (!ok)
+        ++g_failures;
+}
+
+// Feeds @p frames frames of @p ms and returns the level afterwards.
+int run(QualityPolicy &policy, int frames, double ms)
+{
+    for (int i = 0; i < frames; ++i)
+        policy.addFrame(ms, kBudget);
+    return policy.level();
+}
+
+} // namespace
+
+int main()
+{
+    // A frame that keeps up still waits for vblank: about one budget.
+    {
+        QualityPolicy policy(kFull, kMinimal, kFull);
+        check("frames at the refresh rate keep the full look", run(policy, 600, kBudget * 1.02) == kFull);
+    }
+
+    // GPU-bound glow: every swap misses a vblank and takes two budgets.
+    {
+        QualityPolicy policy(kFull, kMinimal, kFull);
+        check("missed vblanks drop one level within a window", run(policy, 20, kBudget * 2) == kFull - 1);
+        check("a sustained GPU-bound load drops to minimal", run(policy, 40, kBudget * 2) == kMinimal);
+        check("never below minimal", run(policy, 100, kBudget * 3) == kMinimal);
+    }
+
+    // A single hitch per window is noise.
+    {
+        QualityPolicy policy(kFull, kMinimal, kFull);
+        bool held = true;
+        for (int i = 0; i < 400; ++i)
+            held = held && policy.addFrame(i % 20 == 0 ? kBudget * 4 : kBudget, kBudget) == kFull;
+        check("isolated hitches keep the level", held);
+    }
+
+    // Recovery, slower after every drop.
+    {
+        QualityPolicy policy(kFull, kMinimal, kFull);
+        run(policy, 20, kBudget * 2);
+        check("cheap frames do not raise before twelve clean windows",
+              run(policy, 11 * 20, kBudget) == kFull - 1);
+        check("twelve clean windows raise the level", run(policy, 20, kBudget) == kFull);
+        run(policy, 20, kBudget * 2);
+        check("the next raise needs twice as long", run(policy, 12 * 20, kBudget) == kFull - 1);
+    }
+
+    return g_failures == 0 ? 0 : 1;
+}
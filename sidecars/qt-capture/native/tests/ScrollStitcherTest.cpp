@@ -0,0 +1,167 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ScrollStitcher.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+// Rows are stand-ins for their hashes: 0 is a blank row, everything else
+// is unique, so a frame is just the ids of the rows it shows.
+constexpr uint64_t kBlank = 0;
+constexpr int kViewport = 100;
+
+struct Page
+{
+    std::vector<uint64_t> header;
+    std::vector<uint64_t> document;
+    std::vector<uint64_t> footer;
+
+    std::vector<uint64_t> frame(int offset) const
+    {
+        std::vector<uint64_t> rows(header);
+        const int body = kViewport - int(header.size()) - int(footer.size());
+        rows.insert(rows.end(), document.begin() + offset, document.begin() + offset + body);
+        rows.insert(rows.end(), footer.begin(), footer.end());
+        return rows;
+    }
+
+    int lastOffset() const
+    {
+        return int(document.size()) - (kViewport - int(header.size()) - int(footer.size()));
+    }
+};
+
+std::vector<uint64_t> uniqueRows(uint64_t first, int count)
+{
+    std::vector<uint64_t> rows;
+    for (int i = 0; i < count; ++i)
+        rows.push_back(first + uint64_t(i));
+    return rows;
+}
+
+// Document that opens with a blank margin, like most web pages.
+std::vector<uint64_t> blankTopDocument(int blank, int text)
+{
+    std::vector<uint64_t> rows(size_t(blank), kBlank);
+    const std::vector<uint64_t> body = uniqueRows(1000, text);
+    rows.insert(rows.end(), body.begin(), body.end());
+    return rows;
+}
+
+// Scrolls @p page by each of @p steps (repeating the frame for a still
+// tick) and returns the rows a ScrollCapture would have written. Jumps
+// past the overlap search are counted in @p gaps.
+std::vector<uint64_t> stitch(const Page &page, const std::vector<int> &steps, int *gaps = nullptr)
+{
+    ScrollStitcher stitcher;
+    std::vector<uint64_t> out;
+    std::vector<uint64_t> prev = page.frame(0);
+    ScrollStitcher::Rows rows;
+    stitcher.next(prev, rows);
+
+    int offset = 0;
+    for (int step : steps)
+    {
+        offset = step < 0 ? offset : std::min(offset + step, page.lastOffset());
+        const std::vector<uint64_t> frame = page.frame(offset);
+        const ScrollStitcher::Motion motion = stitcher.next(frame, rows);
+        if (motion == ScrollStitcher::Motion::Scrolled || motion == ScrollStitcher::Motion::Jumped)
+            out.insert(out.end(), prev.begin() + rows.first, prev.begin() + rows.first + rows.count);
+        if (gaps && motion == ScrollStitcher::Motion::Jumped)
+            ++*gaps;
+        prev = frame;
+    }
+
+    rows = stitcher.remainder();
+    out.insert(out.end(), prev.begin() + rows.first, prev.begin() + rows.first + rows.count);
+    return out;
+}
+
+std::vector<uint64_t> expected(const Page &page)
+{
+    std::vector<uint64_t> rows(page.header);
+    rows.insert(rows.end(), page.document.begin(), page.document.end());
+    rows.insert(rows.end(), page.footer.begin(), page.footer.end());
+    return rows;
+}
+
+int g_failures = 0;
+
+void check(const char *name, const Page &page, const std::vector<int> &steps)
+{
+    const std::vector<uint64_t> got = stitch(page, steps);
+    const std::vector<uint64_t> want = expected(page);
+    if (got == want)
+    {
+        std::printf("PASS %s\n", name);
+        return;
+    }
+
+    ++g_failures;
+    size_t at = 0;
+    while (at < got.size() && at < want.size() && got[at] == want[at])
+        ++at;
+    std::printf("FAIL %s: %zu rows stitched, %zu expected, first difference at row %zu\n",
+                name, got.size(), want.size(), at);
+}
+
+// A scroll past the overlap search but within one viewport: every row was
+// on screen in some frame, so every row must be written, in order. The
+// few rows both frames showed may appear twice at the seam.
+void checkJump(const char *name, const Page &page, const std::vector<int> &steps)
+{
+    int gaps = 0;
+    const std::vector<uint64_t> got = stitch(page, steps, &gaps);
+    const std::vector<uint64_t> want = expected(page);
+
+    size_t matched = 0;
+    for (size_t i = 0; i < got.size() && matched < want.size(); ++i)
+        matched += got[i] == want[matched];
+
+    if (matched == want.size() && gaps > 0)
+    {
+        std::printf("PASS %s\n", name);
+        return;
+    }
+
+    ++g_failures;
+    std::printf("FAIL %s: %zu of %zu rows kept in order, %d gaps reported\n",
+                name, matched, want.size(), gaps);
+}
+
+} // namespace
+
+int main()
+{
+    const std::vector<int> even(30, 10);
+    const std::vector<int> uneven = {7, 13, -1, 4, 21, -1, -1, 9, 30, 2, 17, 11, 25, 5, 40, 40, 40, 40, 40};
+
+    Page plain;
+    plain.document = uniqueRows(1000, 400);
+    check("plain document", plain, even);
+
+    Page blankTop;
+    blankTop.document = blankTopDocument(30, 370);
+    check("blank top margin", blankTop, even);
+    check("blank top margin, uneven scrolling", blankTop, uneven);
+
+    Page sticky;
+    sticky.header = uniqueRows(1, 12);
+    sticky.footer = uniqueRows(500, 6);
+    sticky.document = blankTopDocument(45, 355);
+    check("sticky header and footer over a blank top margin", sticky, uneven);
+
+    // 95 of 100 rows, then 78 of an 82-row band: past the 12 and 10 row
+    // minimum overlaps.
+    checkJump("scroll past the overlap window", plain, {10, 10, 95, 10, 10, 40, 40, 40, 40, 40});
+    checkJump("scroll past the overlap window under a sticky header", sticky,
+              {7, 13, 78, 9, 30, 40, 40, 40, 40, 40, 40});
+
+    return g_failures == 0 ? 0 : 1;
+}
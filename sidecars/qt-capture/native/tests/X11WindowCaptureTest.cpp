@@ -0,0 +1,124 @@
+/**
+ * @license
+ * Copyright 2026 a7mddra
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Grabs real windows on an X server (run under Xvfb, see CMakeLists.txt):
+ * a window partly covered by another is captured without the cover, and
+ * GetImage reads of the root come back at the right size and colour. The
+ * odd width makes the server pad rows at 16 bpp.
+ */
+
+#include "X11WindowCapture.h"
+#include "XcbShmImage.h"
+#include <QGuiApplication>
+#include <QtGui/qguiapplication_platform.h>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+constexpr int kSkip = 77;
+
+int g_failures = 0;
+
+void check(const char *name, bool ok)
+{
+    std::printf("%s %s\n", ok ? "PASS" : "FAIL", name);
+    if (!ok)
+        ++g_failures;
+}
+
+const xcb_visualtype_t *rootVisual(const xcb_screen_t *screen)
+{
+    for (auto depth = xcb_screen_allowed_depths_iterator(screen); depth.rem; xcb_depth_next(&depth))
+    {
+        for (auto visual = xcb_depth_visuals_iterator(depth.data); visual.rem; xcb_visualtype_next(&visual))
+        {
+            if (visual.data->visual_id == screen->root_visual)
+                return visual.data;
+        }
+    }
+    return nullptr;
+}
+
+xcb_window_t createWindow(xcb_connection_t *conn, const xcb_screen_t *screen, const QRect &rect, uint32_t pixel)
+{
+    const xcb_window_t window = xcb_generate_id(conn);
+    const uint32_t values[] = {pixel, 1};
+    xcb_create_window(conn, XCB_COPY_FROM_PARENT, window, screen->root,
+                      int16_t(rect.x()), int16_t(rect.y()), uint16_t(rect.width()), uint16_t(rect.height()), 0,
+                      XCB_WINDOW_CLASS_INPUT_OUTPUT, screen->root_visual,
+                      XCB_CW_BACK_PIXEL | XCB_CW_OVERRIDE_REDIRECT, values);
+    xcb_map_window(conn, window);
+    return window;
+}
+
+void sync(xcb_connection_t *conn)
+{
+    free(xcb_get_input_focus_reply(conn, xcb_get_input_focus(conn), nullptr));
+}
+
+bool filledWith(const QImage &image, QRgb colour)
+{
+    for (int y = 0; y < image.height(); ++y)
+    {
+        for (int x = 0; x < image.width(); ++x)
+        {
+            if ((image.pixel(x, y) & 0xffffff) != (colour & 0xffffff))
+                return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QGuiApplication app(argc, argv);
+
+    auto *x11 = qGuiApp->nativeInterface<QNativeInterface::QX11Application>();
+    if (!x11 || !x11->connection())
+    {
+        std::printf("SKIP no X11 connection\n");
+        return kSkip;
+    }
+    xcb_connection_t *conn = x11->connection();
+    const xcb_screen_t *screen = xcb_setup_roots_iterator(xcb_get_setup(conn)).data;
+    const xcb_visualtype_t *visual = rootVisual(screen);
+    if (!visual || visual->_class != XCB_VISUAL_CLASS_TRUE_COLOR)
+    {
+        std::printf("SKIP root visual is not TrueColor\n");
+        return kSkip;
+    }
+
+    const QRect target(10, 10, 63, 41);
+    const QRect cover(30, 20, 31, 40);
+    const xcb_window_t window = createWindow(conn, screen, target, visual->red_mask);
+    createWindow(conn, screen, cover, visual->blue_mask);
+    sync(conn);
+
+    std::printf("root depth %d\n", int(screen->root_depth));
+
+    QRect geometry;
+    const QImage grabbed = captureX11Window(conn, window, &geometry);
+    check("window grab succeeds", !grabbed.isNull());
+    check("window grab has the window's size", grabbed.size() == target.size());
+    check("window geometry is reported in root coordinates", geometry == target);
+    check("covered window grabs without the cover", filledWith(grabbed, qRgb(255, 0, 0)));
+
+    XcbShmImage shm(conn);
+    const QImage shared = shm.grab(screen->root, cover);
+    check("MIT-SHM root grab has the requested size", shared.size() == cover.size());
+    check("MIT-SHM root grab reads the top window", filledWith(shared, qRgb(0, 0, 255)));
+
+    XcbShmImage plain(conn, false);
+    const QImage fallback = plain.grab(screen->root, cover);
+    check("GetImage root grab has the requested size", fallback.size() == cover.size());
+    check("GetImage root grab reads the top window", filledWith(fallback, qRgb(0, 0, 255)));
+
+    return g_failures == 0 ? 0 : 1;
+}
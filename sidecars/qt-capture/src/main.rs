@@ -7,14 +7,12 @@ mod qt_app;
 use anyhow::Result;
 use std::process::ExitCode;
 use qt_app::QtApp;
-use sys_shutter_suppressor::AudioGuard;
 
 fn main() -> ExitCode {
     match run() {
         Ok(code) => code,
         Err(e) => {
             eprintln!("[qt-capture] Error: {:#}", e);
-            AudioGuard::unmute();
             ExitCode::from(1)
         }
     }
@@ -22,7 +22,8 @@ impl QtApp {
         let _lock = InstanceLock::try_acquire("qt-capture")
             .context("Failed to acquire instance lock - is another capture running?")?;
 
-        AudioGuard::mute();
+        // Mutes on its own thread while the Qt process starts.
+        let audio = AudioGuard::mute();
 
         let mut child = self.spawn_process()?;
         let child_pid = child.id();
@@ -35,9 +36,13 @@ impl QtApp {
 
         let exit_code = self.handle_ipc(&mut child);
 
+        // Every result line is out by now. Restore the audio right away, but
+        // hold the instance lock until the Qt process is gone: it may still
+        // be storing the session in the history (--history), and a second
+        // capture must not start next to it.
         watcher.stop();
+        audio.unmute();
         let _ = child.wait();
-        AudioGuard::unmute();
 
         Ok(exit_code)
     }
@@ -62,6 +67,13 @@ impl QtApp {
             let reader = BufReader::new(stdout);
             let mut capture_success = false;
             let mut capture_path: Option<String> = None;
+            let mut watch_frame = false;
+            let mut watched = false;
+            let mut ocr_result = false;
+            let mut code_result = false;
+            let mut preview = false;
+            let mut calibrated = false;
+            let mut calibration = false;
 
             for line in reader.lines() {
                 match line {
@@ -72,13 +84,60 @@ impl QtApp {
                             "CAPTURE_SUCCESS" => {
                                 capture_success = true;
                             }
+                            "CALIBRATED" => {
+                                calibration = true;
+                            }
+                            "CAPTURE_PREVIEW" => {
+                                preview = true;
+                            }
                             "CAPTURE_FAIL" => {
                                 break;
                             }
+                            "WATCH_FRAME" => {
+                                watch_frame = true;
+                            }
+                            "OCR_RESULT" => {
+                                ocr_result = true;
+                            }
+                            "OCR_FAIL" => {
+                                eprintln!("[Qt] OCR worker handoff failed");
+                            }
+                            "OCR_SKIPPED" => {}
+                            "CODE_RESULT" => {
+                                code_result = true;
+                            }
+                            "CODE_NONE" => {}
                             _ => {
-                                if trimmed.starts_with('/') && capture_success {
+                                if trimmed.starts_with("EVENT ") {
+                                    // Versioned lifecycle event (--events), passed through as-is
+                                    println!("{}", trimmed);
+                                } else if calibration && trimmed.starts_with('{') {
+                                    // --calibrate summary (backend, grab_ms, encoder_threads)
+                                    println!("{}", trimmed);
+                                    calibration = false;
+                                    calibrated = true;
+                                } else if ocr_result && trimmed.starts_with('{') {
+                                    // Warm OCR worker reply, printed after the capture path
+                                    println!("{}", trimmed);
+                                    ocr_result = false;
+                                } else if code_result && trimmed.starts_with('{') {
+                                    // Decoded QR/barcodes ({"codes": [...]}); OCR is skipped
+                                    println!("{}", trimmed);
+                                    code_result = false;
+                                } else if trimmed.starts_with('/') && preview {
+                                    // Downscaled preview (--preview); the full path follows
+                                    println!("PREVIEW {}", trimmed);
+                                    preview = false;
+                                } else if trimmed.starts_with('/') && watch_frame {
+                                    // Watch mode streams one path per changed frame
+                                    println!("{}", trimmed);
+                                    watch_frame = false;
+                                    watched = true;
+                                } else if trimmed.starts_with('/') && capture_success {
+                                    // Keep reading: an OCR reply may follow the path
+                                    println!("{}", trimmed);
                                     capture_path = Some(trimmed.to_string());
-                                    break;
+                                    capture_success = false;
                                 } else {
                                     eprintln!("[Qt] {}", trimmed);
                                 }
@@ -89,8 +148,9 @@ impl QtApp {
                 }
             }
 
-            if let Some(path) = capture_path {
-                println!("{}", path);
+            if capture_path.is_some() {
+                ExitCode::from(0)
+            } else if watched || calibrated {
                 ExitCode::from(0)
             } else {
                 ExitCode::from(1)
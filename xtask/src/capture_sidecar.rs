@@ -19,15 +19,22 @@ fn qt_native_dir() -> std::path::PathBuf {
     sidecar_dir().join("native")
 }
 
-pub fn build() -> Result<()> {
+/// With `pgo`, the LTO + PGO variant is built after the plain Release one
+/// (which serves as its measured baseline) and is what gets packaged.
+pub fn build(pgo: bool) -> Result<()> {
     println!("\nBuilding Capture Engine...");
 
     // 1. Build Qt (CMake)
     build_qt_native()?;
+    let build_dir = if pgo {
+        build_qt_pgo()?
+    } else {
+        qt_native_dir().join("build")
+    };
 
     // 2. Deploy Qt (Bundle)
     println!("\nDeploying Qt runtime...");
-    deploy_qt_native()?;
+    deploy_qt_native(&build_dir)?;
 
     // 3. Sign (macOS only)
     #[cfg(target_os = "macos")]
@@ -53,6 +60,20 @@ pub fn build_qt_only() -> Result<()> {
     Ok(())
 }
 
+pub fn build_qt_pgo() -> Result<std::path::PathBuf> {
+    println!("\nBuilding Qt native binary with LTO + PGO...");
+
+    #[cfg(unix)]
+    {
+        let build_dir = crate::qt::pgo::build(&qt_native_dir())?;
+        println!("\nPGO build complete: {}", build_dir.display());
+        Ok(build_dir)
+    }
+
+    #[cfg(windows)]
+    anyhow::bail!("The PGO variant is only scripted for GCC/Clang toolchains");
+}
+
 fn build_qt_native() -> Result<()> {
     println!("\nRunning Qt CMake build...");
 
@@ -70,17 +91,17 @@ fn build_qt_native() -> Result<()> {
     Ok(())
 }
 
-fn deploy_qt_native() -> Result<()> {
+fn deploy_qt_native(build_dir: &std::path::Path) -> Result<()> {
     let native_dir = qt_native_dir();
 
     #[cfg(target_os = "linux")]
-    crate::qt::linux::deploy(&native_dir)?;
+    crate::qt::linux::deploy(&native_dir, build_dir)?;
 
     #[cfg(target_os = "macos")]
-    crate::qt::macos::deploy(&native_dir)?;
+    crate::qt::macos::deploy(&native_dir, build_dir)?;
 
     #[cfg(target_os = "windows")]
-    crate::qt::windows::deploy(&native_dir)?;
+    crate::qt::windows::deploy(&native_dir, build_dir)?;
 
     Ok(())
 }
@@ -163,7 +184,7 @@ pub fn clean() -> Result<()> {
 
     let native_dir = qt_native_dir();
 
-    for dir in ["build", "dist"] {
+    for dir in ["build", "build-pgo", "dist"] {
         let path = native_dir.join(dir);
         if path.exists() {
             println!("  Removing {}", path.display());
@@ -6,6 +6,7 @@
 //!   cargo xtask build-ocr          Build PaddleOCR sidecar executable
 //!   cargo xtask build-capture      Build Capture Engine (Qt + Rust)
 //!   cargo xtask build-capture-qt   Build Qt native only (no Rust)
+//!   cargo xtask build-capture-pgo  Build Qt native with LTO + PGO and measure it
 //!   cargo xtask clean              Clean all build artifacts
 //!   cargo xtask run <cmd>          Run Tauri commands (dev, build, etc.)
 
@@ -35,11 +36,18 @@ enum Commands {
     BuildOcr,
 
     /// Build Capture Engine (Qt + Rust + Package)
-    BuildCapture,
+    BuildCapture {
+        /// Package the LTO + PGO variant instead of the plain Release build
+        #[arg(long)]
+        pgo: bool,
+    },
 
     /// Build Qt native only (CMake only, no Bundle)
     BuildCaptureQt,
 
+    /// Build Qt native with LTO + PGO from a headless training run
+    BuildCapturePgo,
+
     /// Build Tauri application for release
     BuildApp,
 
@@ -62,18 +70,21 @@ fn main() -> Result<()> {
     match cli.command {
         Commands::Build => {
             ocr_sidecar::build()?;
-            capture_sidecar::build()?;
+            capture_sidecar::build(false)?;
             tauri::build()?;
         }
         Commands::BuildOcr => {
             ocr_sidecar::build()?;
         }
-        Commands::BuildCapture => {
-            capture_sidecar::build()?;
+        Commands::BuildCapture { pgo } => {
+            capture_sidecar::build(pgo)?;
         }
         Commands::BuildCaptureQt => {
             capture_sidecar::build_qt_only()?;
         }
+        Commands::BuildCapturePgo => {
+            capture_sidecar::build_qt_pgo()?;
+        }
         Commands::BuildApp => {
             tauri::build()?;
         }
@@ -25,6 +25,7 @@ pub fn build(native_dir: &Path) -> Result<()> {
             "-B",
             build_dir.to_str().unwrap(),
             "-DCMAKE_BUILD_TYPE=Release",
+            "-DCAPTURE_FETCH_ZXING=ON",
             // We rely on the environment variables (Qt6_DIR) set in Docker
         ])
         .status()
@@ -54,12 +55,11 @@ pub fn build(native_dir: &Path) -> Result<()> {
     Ok(())
 }
 
-pub fn deploy(native_dir: &Path) -> Result<()> {
-    let build_dir = native_dir.join("build");
+pub fn deploy(native_dir: &Path, build_dir: &Path) -> Result<()> {
     let runtime_dir = native_dir.join("qt-runtime");
 
     println!("  Creating 'qt-runtime' distribution using linuxdeployqt...");
-    create_runtime_distribution(native_dir, &build_dir, &runtime_dir)?;
+    create_runtime_distribution(native_dir, build_dir, &runtime_dir)?;
 
     Ok(())
 }
@@ -97,6 +97,16 @@ fn create_runtime_distribution(
         fs::set_permissions(&dst_bin, fs::Permissions::from_mode(0o755))?;
     }
 
+    // Ship the embeddable capture_core library next to the bundled Qt libs.
+    // It links the same Qt libraries as capture-bin, so linuxdeployqt's
+    // bundle already covers its dependencies.
+    let src_core = build_dir.join("libcapture_core.so");
+    if src_core.exists() {
+        let lib_dir = runtime_dir.join("usr/lib");
+        fs::create_dir_all(&lib_dir)?;
+        fs::copy(&src_core, lib_dir.join("libcapture_core.so"))?;
+    }
+
     // RUN THE MAGIC TOOL
     // -bundle-non-qt-libs: includes SSL, etc.
     // -always-overwrite: Good for repeated local builds
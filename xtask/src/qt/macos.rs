@@ -28,6 +28,7 @@ pub fn build(native_dir: &Path) -> Result<()> {
             "-B",
             build_dir.to_str().unwrap(),
             "-DCMAKE_BUILD_TYPE=Release",
+            "-DCAPTURE_FETCH_ZXING=ON",
             &format!("-DCMAKE_PREFIX_PATH={}", qt_prefix),
         ])
         .status()
@@ -56,14 +57,13 @@ pub fn build(native_dir: &Path) -> Result<()> {
     Ok(())
 }
 
-pub fn deploy(native_dir: &Path) -> Result<()> {
-    let build_dir = native_dir.join("build");
+pub fn deploy(native_dir: &Path, build_dir: &Path) -> Result<()> {
     let dist_dir = native_dir.join("qt-runtime"); // Changed to qt-runtime for consistency
 
     let qt_prefix = find_qt_prefix()?;
 
     println!("  Running macdeployqt...");
-    create_distribution(&build_dir, &dist_dir, &qt_prefix)?;
+    create_distribution(build_dir, &dist_dir, &qt_prefix)?;
 
     Ok(())
 }
@@ -9,3 +9,6 @@ pub mod macos;
 
 #[cfg(target_os = "windows")]
 pub mod windows;
+
+#[cfg(unix)]
+pub mod pgo;
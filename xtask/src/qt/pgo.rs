@@ -0,0 +1,233 @@
+// Copyright 2026 a7mddra
+// SPDX-License-Identifier: Apache-2.0
+
+//! LTO + PGO build variant of the Qt capture binary.
+//!
+//! Stage 1 builds an instrumented binary, runs the hidden `--pgo-train`
+//! session headless (offscreen platform) once per canvas mode, then
+//! stage 2 rebuilds in the same tree with the collected profile. Finally
+//! the training session is timed on the plain Release build (if present)
+//! and on the optimized one, and the medians are written to
+//! `native/pgo-results.md` so they can be committed with the change that
+//! produced them.
+
+use anyhow::{Context, Result};
+use std::fmt::Write as _;
+use std::fs;
+use std::path::{Path, PathBuf};
+use std::process::{Command, Output};
+use std::time::Instant;
+
+const TRAINING_MODES: [&str; 2] = ["--freeshape", "--rectangle"];
+const MEASURE_RUNS: usize = 5;
+const RESULTS_FILE: &str = "pgo-results.md";
+
+/// Builds the optimized binary into `native/build-pgo` and returns that
+/// directory.
+pub fn build(native_dir: &Path) -> Result<PathBuf> {
+    let build_dir = native_dir.join("build-pgo");
+    let profile_dir = build_dir.join("pgo-profile");
+
+    if profile_dir.exists() {
+        fs::remove_dir_all(&profile_dir)?;
+    }
+    fs::create_dir_all(&profile_dir)?;
+
+    println!("  [1/4] Instrumented build...");
+    configure_and_build(native_dir, &build_dir, &profile_dir, "GENERATE")?;
+
+    println!("  [2/4] Training run...");
+    let instrumented = binary_path(&build_dir);
+    for mode in TRAINING_MODES {
+        let mut cmd = training_command(&instrumented, mode);
+        cmd.env("LLVM_PROFILE_FILE", profile_dir.join("capture-%p.profraw"));
+        run_captured(&mut cmd, "Training", mode)?;
+    }
+    merge_clang_profiles(&profile_dir)?;
+
+    println!("  [3/4] Optimized build...");
+    configure_and_build(native_dir, &build_dir, &profile_dir, "USE")?;
+
+    println!(
+        "  [4/4] Measuring training session (median of {} runs)...",
+        MEASURE_RUNS
+    );
+    let mut results = String::from(
+        "| Build | Mode | Overlay visible (ms) | Crop+encode (ms) | Session (ms) |\n\
+         |---|---|---|---|---|\n",
+    );
+    let baseline = binary_path(&native_dir.join("build"));
+    if baseline.exists() {
+        report("Release", &baseline, &mut results)?;
+    } else {
+        println!(
+            "    (no plain Release build at {}, skipping baseline)",
+            baseline.display()
+        );
+    }
+    report("LTO+PGO", &binary_path(&build_dir), &mut results)?;
+
+    let results_path = native_dir.join(RESULTS_FILE);
+    fs::write(&results_path, results)
+        .with_context(|| format!("Failed to write {}", results_path.display()))?;
+    println!("    Results written to {}", results_path.display());
+
+    Ok(build_dir)
+}
+
+fn configure_and_build(
+    native_dir: &Path,
+    build_dir: &Path,
+    profile_dir: &Path,
+    stage: &str,
+) -> Result<()> {
+    let stage_arg = format!("-DCAPTURE_PGO={}", stage);
+    let dir_arg = format!("-DCAPTURE_PGO_DIR={}", profile_dir.display());
+    let status = Command::new("cmake")
+        .args([
+            "-S",
+            native_dir.to_str().unwrap(),
+            "-B",
+            build_dir.to_str().unwrap(),
+            "-DCMAKE_BUILD_TYPE=Release",
+            "-DCAPTURE_FETCH_ZXING=ON",
+            "-DCAPTURE_LTO=ON",
+            stage_arg.as_str(),
+            dir_arg.as_str(),
+        ])
+        .status()
+        .context("Failed to run cmake configure")?;
+    if !status.success() {
+        anyhow::bail!("CMake configure ({}) failed", stage);
+    }
+
+    let status = Command::new("cmake")
+        .args([
+            "--build",
+            build_dir.to_str().unwrap(),
+            "--config",
+            "Release",
+            "--parallel",
+        ])
+        .status()
+        .context("Failed to run cmake build")?;
+    if !status.success() {
+        anyhow::bail!("CMake build ({}) failed", stage);
+    }
+    Ok(())
+}
+
+/// Clang writes raw profiles that must be merged; GCC's .gcda files are
+/// read in place.
+fn merge_clang_profiles(profile_dir: &Path) -> Result<()> {
+    let raw: Vec<PathBuf> = fs::read_dir(profile_dir)?
+        .filter_map(|e| e.ok().map(|e| e.path()))
+        .filter(|p| p.extension().map_or(false, |ext| ext == "profraw"))
+        .collect();
+    if raw.is_empty() {
+        return Ok(());
+    }
+
+    let mut cmd = Command::new("llvm-profdata");
+    cmd.arg("merge")
+        .arg(format!(
+            "-output={}",
+            profile_dir.join("capture.profdata").display()
+        ))
+        .args(&raw);
+    let status = cmd.status().context("Failed to run llvm-profdata")?;
+    if !status.success() {
+        anyhow::bail!("llvm-profdata merge failed");
+    }
+    Ok(())
+}
+
+fn binary_path(build_dir: &Path) -> PathBuf {
+    if cfg!(target_os = "macos") {
+        build_dir.join("capture.app/Contents/MacOS/capture")
+    } else {
+        build_dir.join("capture-bin")
+    }
+}
+
+fn training_command(binary: &Path, mode: &str) -> Command {
+    let mut cmd = Command::new(binary);
+    cmd.args([mode, "--pgo-train", "--events"])
+        .env("QT_QPA_PLATFORM", "offscreen");
+    cmd
+}
+
+/// Runs `cmd` with its output captured and replays that output when the run
+/// fails, so a broken training or measuring run can still be diagnosed.
+fn run_captured(cmd: &mut Command, label: &str, mode: &str) -> Result<Output> {
+    let output = cmd
+        .output()
+        .with_context(|| format!("Failed to run {:?}", cmd.get_program()))?;
+    if !output.status.success() {
+        eprintln!("{}", String::from_utf8_lossy(&output.stdout));
+        eprintln!("{}", String::from_utf8_lossy(&output.stderr));
+        anyhow::bail!("{} run {} failed: {:?}", label, mode, output.status.code());
+    }
+    Ok(output)
+}
+
+/// t_ms of the first overlay_visible event: startup up to the first
+/// presented overlay frame.
+fn overlay_visible_ms(stdout: &str) -> Option<f64> {
+    let event = stdout
+        .lines()
+        .filter_map(|line| line.strip_prefix("EVENT "))
+        .find(|json| json.contains("\"event\":\"overlay_visible\""))?;
+    let value = event.split_once("\"t_ms\":")?.1;
+    let end = value.find([',', '}']).unwrap_or(value.len());
+    value[..end].parse().ok()
+}
+
+/// Sum of the "[Training] crop+encode WxH: X ms" lines of one session.
+fn crop_encode_ms(stderr: &str) -> Option<f64> {
+    let times: Vec<f64> = stderr
+        .lines()
+        .filter(|line| line.contains("[Training] crop+encode"))
+        .filter_map(|line| line.rsplit_once(": ")?.1.split(' ').next()?.parse().ok())
+        .collect();
+    (!times.is_empty()).then(|| times.iter().sum())
+}
+
+fn median(mut samples: Vec<f64>) -> Option<f64> {
+    if samples.is_empty() {
+        return None;
+    }
+    samples.sort_by(|a, b| a.partial_cmp(b).unwrap());
+    Some(samples[samples.len() / 2])
+}
+
+fn format_ms(value: Option<f64>) -> String {
+    value.map_or_else(|| "-".to_string(), |ms| format!("{:.1}", ms))
+}
+
+fn report(label: &str, binary: &Path, results: &mut String) -> Result<()> {
+    for mode in TRAINING_MODES {
+        let mut overlay = Vec::with_capacity(MEASURE_RUNS);
+        let mut crop = Vec::with_capacity(MEASURE_RUNS);
+        let mut session = Vec::with_capacity(MEASURE_RUNS);
+        for _ in 0..MEASURE_RUNS {
+            let start = Instant::now();
+            let output = run_captured(&mut training_command(binary, mode), label, mode)?;
+            session.push(start.elapsed().as_secs_f64() * 1000.0);
+            overlay.extend(overlay_visible_ms(&String::from_utf8_lossy(&output.stdout)));
+            crop.extend(crop_encode_ms(&String::from_utf8_lossy(&output.stderr)));
+        }
+
+        let row = [median(overlay), median(crop), median(session)].map(format_ms);
+        println!(
+            "    {:<8} {:<12} overlay {:>8} ms, crop+encode {:>8} ms, session {:>8} ms",
+            label, mode, row[0], row[1], row[2]
+        );
+        let _ = writeln!(
+            results,
+            "| {} | {} | {} | {} | {} |",
+            label, mode, row[0], row[1], row[2]
+        );
+    }
+    Ok(())
+}
@@ -31,6 +31,7 @@ pub fn build(native_dir: &Path) -> Result<()> {
             "-G",
             "Ninja",
             "-DCMAKE_BUILD_TYPE=Release",
+            "-DCAPTURE_FETCH_ZXING=ON",
             "-DCMAKE_C_COMPILER=cl.exe",
             "-DCMAKE_CXX_COMPILER=cl.exe",
             &format!("-DCMAKE_PREFIX_PATH={}", qt_path),
@@ -60,14 +61,13 @@ pub fn build(native_dir: &Path) -> Result<()> {
     Ok(())
 }
 
-pub fn deploy(native_dir: &Path) -> Result<()> {
-    let build_dir = native_dir.join("build");
+pub fn deploy(native_dir: &Path, build_dir: &Path) -> Result<()> {
     let dist_dir = native_dir.join("qt-runtime"); // Changed dist to qt-runtime for consistency
 
     let qt_path = find_qt_path()?;
 
     println!("  Running windeployqt...");
-    create_distribution(&build_dir, &dist_dir, &qt_path)?;
+    create_distribution(build_dir, &dist_dir, &qt_path)?;
 
     Ok(())
 }